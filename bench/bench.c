@@ -0,0 +1,123 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   bench.c                                            :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: myli-pen <myli-pen@student.hive.fi>        +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/17 23:26:55 by myli-pen          #+#    #+#             */
+/*   Updated: 2026/10/18 04:03:18 by myli-pen         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "bench.h"
+
+static inline bool		bench_map(char *path, char *name);
+static inline bool		run_stage(t_bench *b, char *stage, t_stage fn);
+static inline double	now(void);
+
+/**
+ * Headless benchmark of the map loading path, run by `make bench-parse`.
+ *
+ * Loads every map given as argument without a window, stage by stage, and
+ * reports the time, throughput, allocations and peak RSS of each stage.
+ * An argument `gen:N` generates an N x N map in the temporary directory.
+ *
+ * @param argc Arguments count.
+ * @param argv Map paths and generated map sizes.
+ * @return EXIT_SUCCESS if every map loaded.
+ */
+int	main(int argc, char **argv)
+{
+	char	*path;
+	bool	ok;
+	int		i;
+
+	printf("%-28s %-12s %10s %9s %9s %9s %9s %9s\n", "map", "stage", "ms",
+		"MB/s", "Mverts/s", "mallocs", "malloc MB", "peak MB");
+	ok = true;
+	i = 0;
+	while (++i < argc)
+	{
+		path = argv[i];
+		if (!ft_strncmp(path, "gen:", 4))
+			path = gen_map(ft_atoi(path + 4));
+		ok = path && bench_map(path, argv[i]) && ok;
+		if (path && path != argv[i])
+			remove_map(path);
+	}
+	if (ok)
+		return (EXIT_SUCCESS);
+	return (EXIT_FAILURE);
+}
+
+/**
+ * Benchmarks the stages of loading a map like the loader thread does:
+ * opening and mapping it, parsing or importing it, computing its bounds,
+ * writing its cache, and loading it again from the cache.
+ * Caches of the map are removed before and after, so the map is always
+ * parsed and the tree is left as it was.
+ *
+ * @param path Path to the map file.
+ * @param name Name of the map in the report.
+ * @return `true` if every stage succeeded.
+ */
+static inline bool	bench_map(char *path, char *name)
+{
+	t_bench	b;
+	bool	ok;
+
+	remove_cache(path);
+	b.name = name;
+	ok = bench_init(&b, path) && run_stage(&b, "open", stage_open) &&
+		run_stage(&b, "load", stage_load) &&
+		run_stage(&b, "bounds", stage_bounds) &&
+		run_stage(&b, "cache write", stage_write) &&
+		run_stage(&b, "cache read", stage_read);
+	bench_free(&b);
+	remove_cache(path);
+	if (!ok)
+		printf("%-28s failed\n", name);
+	return (ok);
+}
+
+/**
+ * Runs and reports a stage. The throughput is given for the bytes and
+ * vertices the stage processed.
+ *
+ * @param b Benchmark state.
+ * @param stage Name of the stage in the report.
+ * @param fn Stage to run.
+ * @return `true` if the stage succeeded.
+ */
+static inline bool	run_stage(t_bench *b, char *stage, t_stage fn)
+{
+	t_mem	mem;
+	double	t;
+	bool	ok;
+
+	mem_reset();
+	t = now();
+	ok = fn(b);
+	t = fmax(now() - t, 1e-9);
+	mem_usage(&mem);
+	if (ok)
+		printf("%-28s %-12s %10.3f %9.1f %9.2f %9zu %9.1f %9.1f\n",
+			b->name, stage, t * 1e3, b->bytes / t / 1048576.0,
+			b->verts / t / 1e6, mem.allocs, mem.bytes / 1048576.0,
+			mem.peak_kb / 1024.0);
+	return (ok);
+}
+
+/**
+ * Returns the time of a monotonic clock.
+ *
+ * @return Time in seconds.
+ */
+static inline double	now(void)
+{
+	struct timespec	ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (ts.tv_sec + ts.tv_nsec * 1e-9);
+}
@@ -0,0 +1,53 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   bench.h                                            :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: myli-pen <myli-pen@student.hive.fi>        +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/17 23:26:55 by myli-pen          #+#    #+#             */
+/*   Updated: 2026/10/17 23:26:55 by myli-pen         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#ifndef BENCH_H
+# define BENCH_H
+
+# include <time.h>
+# include <sys/resource.h>
+
+# include "fdf.h"
+
+typedef struct s_mem
+{
+	size_t	allocs;
+	size_t	bytes;
+	size_t	peak_kb;
+}				t_mem;
+
+typedef struct s_bench
+{
+	t_context	*ctx;
+	t_options	opt;
+	char		*path;
+	char		*name;
+	size_t		bytes;
+	size_t		verts;
+}				t_bench;
+
+typedef bool	(*t_stage)(t_bench *b);
+
+bool	bench_init(t_bench *b, char *path);
+void	bench_free(t_bench *b);
+bool	stage_open(t_bench *b);
+bool	stage_load(t_bench *b);
+bool	stage_bounds(t_bench *b);
+bool	stage_write(t_bench *b);
+bool	stage_read(t_bench *b);
+char	*gen_map(int size);
+void	remove_map(char *path);
+void	remove_cache(char *path);
+bool	mem_reset(void);
+void	mem_usage(t_mem *mem);
+
+#endif
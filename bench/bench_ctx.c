@@ -0,0 +1,57 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   bench_ctx.c                                        :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: myli-pen <myli-pen@student.hive.fi>        +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/17 23:28:26 by myli-pen          #+#    #+#             */
+/*   Updated: 2026/10/17 23:53:29 by myli-pen         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "bench.h"
+
+/**
+ * Allocates a rendering context without window for the map, in the state
+ * `initialize()` and `start_loader()` leave it in before loading.
+ *
+ * @param b Benchmark state receiving the context.
+ * @param path Path to the map file.
+ * @return `true` on success, `false` on allocation failure or bad map path.
+ */
+bool	bench_init(t_bench *b, char *path)
+{
+	t_context	*ctx;
+
+	b->path = path;
+	b->ctx = ft_calloc(1, sizeof(t_context));
+	ctx = b->ctx;
+	if (!ctx)
+		return (false);
+	if (pthread_mutex_init(&ctx->load.lock, NULL) != 0 ||
+		pthread_cond_init(&ctx->load.resized, NULL) != 0)
+		return (false);
+	atomic_init(&ctx->load.state, LOAD_SCANNING);
+	atomic_init(&ctx->load.cancel, false);
+	ctx->load.alt = vec2i(INT_MAX, INT_MIN);
+	ctx->transform.scale = vec3_n(1.0f);
+	return (parse_args(2, (char *[]){"fdf", path}, &b->opt));
+}
+
+/**
+ * Frees the rendering context of the benchmark and everything it holds.
+ *
+ * @param b Benchmark state.
+ */
+void	bench_free(t_bench *b)
+{
+	t_context	*ctx;
+
+	ctx = b->ctx;
+	if (!ctx)
+		return ;
+	fdf_free(ctx);
+	free(ctx);
+	b->ctx = NULL;
+}
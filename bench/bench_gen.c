@@ -0,0 +1,97 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   bench_gen.c                                        :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: myli-pen <myli-pen@student.hive.fi>        +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/17 23:28:26 by myli-pen          #+#    #+#             */
+/*   Updated: 2026/10/18 02:57:29 by myli-pen         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "bench.h"
+
+static inline void	write_map(FILE *out, int size);
+
+/**
+ * Generates a square map of rolling hills in the temporary directory, with
+ * a color on every seventh point, to benchmark maps larger than the samples.
+ *
+ * @param size Number of rows and columns.
+ * @return Allocated path of the map, or NULL on failure.
+ */
+char	*gen_map(int size)
+{
+	char	*path;
+	FILE	*out;
+	int		fd;
+
+	path = ft_strdup("/tmp/fdf_bench_XXXXXX.fdf");
+	fd = -1;
+	if (size >= 2 && size <= 1 << 15 && path)
+		fd = mkstemps(path, 4);
+	out = NULL;
+	if (fd >= 0)
+		out = fdopen(fd, "w");
+	if (out)
+		write_map(out, size);
+	if (out && fclose(out) == 0)
+		return (path);
+	if (fd >= 0 && !out)
+		close(fd);
+	remove_map(path);
+	return (NULL);
+}
+
+/**
+ * Writes the points of a generated map.
+ *
+ * @param out Map file.
+ * @param size Number of rows and columns.
+ */
+static inline void	write_map(FILE *out, int size)
+{
+	int	i;
+
+	i = -1;
+	while (++i < size * size)
+	{
+		fprintf(out, "%d", (int)(20.0 * sin(i % size * 0.05) *
+				cos(i / size * 0.07)) + i / 3 % 5);
+		if (i % 7 == 0)
+			fprintf(out, ",0x%06X", (i * 2654435761u) & 0xFFFFFF);
+		fputc(" \n"[(i + 1) % size == 0], out);
+	}
+}
+
+/**
+ * Removes a generated map and its cache.
+ *
+ * @param path Allocated path of the map.
+ */
+void	remove_map(char *path)
+{
+	if (!path)
+		return ;
+	remove_cache(path);
+	unlink(path);
+	free(path);
+}
+
+/**
+ * Removes the cache of a map. Its temporary file has a unique name, and is
+ * removed by `finish_cache()`.
+ *
+ * @param path Path to the map file.
+ */
+void	remove_cache(char *path)
+{
+	char	*cache;
+
+	cache = cache_path(path);
+	if (!cache)
+		return ;
+	unlink(cache);
+	free(cache);
+}
@@ -0,0 +1,118 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   bench_mem.c                                        :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: myli-pen <myli-pen@student.hive.fi>        +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/17 23:28:39 by myli-pen          #+#    #+#             */
+/*   Updated: 2026/10/17 23:28:39 by myli-pen         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "bench.h"
+
+void	*__real_malloc(size_t size);
+void	*__real_calloc(size_t count, size_t size);
+void	*__real_realloc(void *ptr, size_t size);
+
+static atomic_size_t	g_allocs;
+static atomic_size_t	g_bytes;
+
+/**
+ * Counts the allocations and allocated bytes of the benchmark, linked with
+ * `-Wl,--wrap=malloc` so every call to malloc() lands here.
+ *
+ * @param size Size of the allocation.
+ * @return Allocated memory, or NULL on failure.
+ */
+void	*__wrap_malloc(size_t size)
+{
+	atomic_fetch_add_explicit(&g_allocs, 1, memory_order_relaxed);
+	atomic_fetch_add_explicit(&g_bytes, size, memory_order_relaxed);
+	return (__real_malloc(size));
+}
+
+/**
+ * Counts the allocations and allocated bytes of calloc().
+ *
+ * @param count Number of elements.
+ * @param size Size of an element.
+ * @return Allocated memory, or NULL on failure.
+ */
+void	*__wrap_calloc(size_t count, size_t size)
+{
+	atomic_fetch_add_explicit(&g_allocs, 1, memory_order_relaxed);
+	atomic_fetch_add_explicit(&g_bytes, count * size, memory_order_relaxed);
+	return (__real_calloc(count, size));
+}
+
+/**
+ * Counts the allocations and allocated bytes of realloc(), each growth
+ * counting as a new allocation of the full size.
+ *
+ * @param ptr Memory to resize.
+ * @param size New size.
+ * @return Reallocated memory, or NULL on failure.
+ */
+void	*__wrap_realloc(void *ptr, size_t size)
+{
+	atomic_fetch_add_explicit(&g_allocs, 1, memory_order_relaxed);
+	atomic_fetch_add_explicit(&g_bytes, size, memory_order_relaxed);
+	return (__real_realloc(ptr, size));
+}
+
+/**
+ * Resets the allocation counters and the peak resident set size, so the
+ * next `mem_usage()` reports a single stage. The kernel peak is reset by
+ * writing 5 to /proc/self/clear_refs, where supported.
+ *
+ * @return `true` if the peak resident set size was reset.
+ */
+bool	mem_reset(void)
+{
+	bool	ok;
+	int		fd;
+
+	atomic_store(&g_allocs, 0);
+	atomic_store(&g_bytes, 0);
+	fd = open("/proc/self/clear_refs", O_WRONLY);
+	if (fd < 0)
+		return (false);
+	ok = write(fd, "5", 1) == 1;
+	close(fd);
+	return (ok);
+}
+
+/**
+ * Reports the allocations since `mem_reset()` and the peak resident set
+ * size, read from VmHWM in /proc/self/status, or from getrusage() which
+ * cannot be reset and covers the whole run.
+ *
+ * @param mem Out memory usage.
+ */
+void	mem_usage(t_mem *mem)
+{
+	struct rusage	usage;
+	char			buf[4096];
+	char			*hwm;
+	ssize_t			len;
+	int				fd;
+
+	mem->allocs = atomic_load(&g_allocs);
+	mem->bytes = atomic_load(&g_bytes);
+	getrusage(RUSAGE_SELF, &usage);
+	mem->peak_kb = usage.ru_maxrss;
+	fd = open("/proc/self/status", O_RDONLY);
+	len = -1;
+	if (fd >= 0)
+		len = read(fd, buf, sizeof(buf) - 1);
+	if (fd >= 0)
+		close(fd);
+	if (len <= 0)
+		return ;
+	buf[len] = '\0';
+	hwm = ft_strnstr(buf, "VmHWM:", len);
+	if (hwm)
+		mem->peak_kb = ft_atoi(hwm + 6);
+}
@@ -0,0 +1,121 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   bench_stages.c                                     :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: myli-pen <myli-pen@student.hive.fi>        +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/17 23:28:03 by myli-pen          #+#    #+#             */
+/*   Updated: 2026/10/18 04:03:18 by myli-pen         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "bench.h"
+
+/**
+ * Opens the map like `initialize()` does, mapping the file without reading
+ * it, so no throughput is reported.
+ *
+ * @param b Benchmark state.
+ * @return `true` if the map was opened.
+ */
+bool	stage_open(t_bench *b)
+{
+	if (!open_map(&b->opt, b->ctx))
+		return (false);
+	b->bytes = 0;
+	b->verts = 0;
+	return (!b->ctx->load.from_cache);
+}
+
+/**
+ * Parses the map text or imports the binary heightmap into the model, the
+ * way the loader thread does, but on the calling thread.
+ *
+ * @param b Benchmark state.
+ * @return `true` if the map was loaded.
+ */
+bool	stage_load(t_bench *b)
+{
+	bool	ok;
+
+	b->bytes = b->ctx->load.file.size;
+	if (b->opt.format == FDF)
+		ok = parse_map(b->ctx);
+	else
+		ok = import_map(b->ctx);
+	b->ctx->load.finished = true;
+	b->verts = (size_t)b->ctx->rows_cols.x * b->ctx->rows_cols.y;
+	return (ok);
+}
+
+/**
+ * Computes the object-space bounds that normalize the model into its model
+ * matrix, and the world-space bounds the camera is framed on.
+ *
+ * @param b Benchmark state.
+ * @return `true`.
+ */
+bool	stage_bounds(t_bench *b)
+{
+	t_context	*ctx;
+
+	ctx = b->ctx;
+	object_bounds(ctx, ctx->load.alt, &ctx->o_center, &ctx->o_bounds);
+	ctx->m.m = model_matrix(ctx);
+	box_bounds(ctx);
+	b->bytes = 0;
+	b->verts = 0;
+	return (true);
+}
+
+/**
+ * Completes the binary cache opened for the map while it was loaded (see
+ * `finish_cache()`).
+ *
+ * @param b Benchmark state.
+ * @return `true` if the cache was written.
+ */
+bool	stage_write(t_bench *b)
+{
+	struct stat	st;
+	char		*path;
+	bool		ok;
+
+	unmap_file(&b->ctx->load.file);
+	if (b->ctx->tiles.enabled)
+		finish_cache(b->ctx, &b->ctx->tiles.map, true);
+	else if (b->ctx->load.cache.data)
+		finish_cache(b->ctx, &b->ctx->load.cache, true);
+	unmap_file(&b->ctx->load.cache);
+	path = cache_path(b->path);
+	ok = path && stat(path, &st) == 0;
+	free(path);
+	b->bytes = 0;
+	if (ok)
+		b->bytes = st.st_size;
+	b->verts = (size_t)b->ctx->rows_cols.x * b->ctx->rows_cols.y;
+	return (ok);
+}
+
+/**
+ * Loads the map again from the cache just written, into a fresh context,
+ * like the next run of the program would.
+ *
+ * @param b Benchmark state.
+ * @return `true` if the model was loaded from the cache.
+ */
+bool	stage_read(t_bench *b)
+{
+	bool	ok;
+
+	bench_free(b);
+	if (!bench_init(b, b->path) || !open_map(&b->opt, b->ctx) ||
+		!b->ctx->load.from_cache)
+		return (false);
+	b->bytes = b->ctx->load.file.size;
+	ok = read_cache(b->ctx);
+	b->ctx->load.finished = true;
+	b->verts = (size_t)b->ctx->rows_cols.x * b->ctx->rows_cols.y;
+	return (ok);
+}
@@ -6,7 +6,7 @@
 /*   By: myli-pen <myli-pen@student.hive.fi>        +#+  +:+       +#+        */
 /*                                                +#+#+#+#+#+   +#+           */
 /*   Created: 2025/07/01 22:37:25 by myli-pen          #+#    #+#             */
-/*   Updated: 2025/08/09 00:33:44 by myli-pen         ###   ########.fr       */
+/*   Updated: 2026/10/18 04:04:16 by myli-pen         ###   ########.fr       */
 /*                                                                            */
 /* ************************************************************************** */
 
@@ -21,6 +21,103 @@
 #  define HEIGHT 1080
 # endif
 
+# ifndef THREADS_MAX
+#  define THREADS_MAX 64
+# endif
+
+# ifndef RASTER_THREADS
+#  define RASTER_THREADS 0
+# endif
+
+# ifndef SEG_BATCH
+#  define SEG_BATCH 65536
+# endif
+
+# define BAND_ROWS 32
+
+# ifndef HZ_SHIFT
+#  define HZ_SHIFT 3
+# endif
+# define HZ_SIZE (1 << HZ_SHIFT)
+
+# ifndef HZ_TEST_MAX
+#  define HZ_TEST_MAX 16
+# endif
+
+# define FIX_DEPTH_ONE 4294967296.0
+# define FIX_DEPTH_MAGIC 6755399441055744.0
+# define FIX_COLOR 16
+
+# ifndef RUN_RATIO
+#  define RUN_RATIO 4
+# endif
+
+# ifndef PARSE_MT_SIZE
+#  define PARSE_MT_SIZE 1048576
+# endif
+
+# ifndef MEM_BUDGET
+#  define MEM_BUDGET 2048
+# endif
+
+# if defined(__APPLE__)
+#  define RSS_SHIFT 10
+# else
+#  define RSS_SHIFT 0
+# endif
+
+# define SCAN_BLOCK 64
+
+# ifndef BATCH_SIZE
+#  define BATCH_SIZE 256
+# endif
+
+# if defined(__AVX2__)
+#  define BATCH_LANES 8
+# elif defined(__SSE2__)
+#  define BATCH_LANES 4
+# else
+#  define BATCH_LANES 1
+# endif
+
+# if defined(__SSE2__)
+#  define SPAN_LANES 4
+# else
+#  define SPAN_LANES 1
+# endif
+
+# define VERT_ALIGN 64
+# define VERT_SIZE 3
+# define PALETTE_SIZE 256
+# define COLOR_ESC 255
+# define Z_ESC INT16_MIN
+
+# define VERT_WIDE 0
+# define VERT_INDEX 1
+# define VERT_COLOR 2
+# define VERT_ARRAYS 3
+
+# define CLIP_LEFT 1
+# define CLIP_RIGHT 2
+# define CLIP_BOTTOM 4
+# define CLIP_TOP 8
+# define CLIP_NEAR 16
+# define CLIP_FAR 32
+
+# define STREAM_BUF 65536
+# define STREAM_ROWS 64
+# define STREAM_POLL 100
+
+# define TILE_SIZE 64
+# define TILE_BYTES 32768
+# define TILE_DATA 4096
+# define TILE_RESIDENT 1
+# define TILE_KNOWN 2
+
+# define CACHE_MAGIC 0x43464446
+# define CACHE_VERSION 5
+# define CACHE_EXT ".fdfc"
+
 # define ZOOM_SENS 0.0018f
 # define PAN_SENS 0.0006f
 # define ORBIT_SENS 0.0025f
@@ -28,7 +125,18 @@
 # include <stdlib.h>
 # include <stdio.h>
 # include <fcntl.h>
+# include <errno.h>
 # include <math.h>
+# include <pthread.h>
+# include <poll.h>
+# include <stdatomic.h>
+# include <sys/mman.h>
+# include <sys/stat.h>
+# include <sys/resource.h>
+
+# if defined(__SSE2__)
+#  include <immintrin.h>
+# endif
 
 # include "MLX42.h"
 # include "libft_io.h"
@@ -56,6 +164,45 @@ typedef enum e_proj
 	PERSPECTIVE
 }				t_proj;
 
+typedef enum e_load_state
+{
+	LOAD_SCANNING,
+	LOAD_PARSING,
+	LOAD_DONE,
+	LOAD_FAILED
+}				t_load_state;
+
+typedef enum e_mem_kind
+{
+	MEM_VERTS,
+	MEM_FRAME,
+	MEM_DEPTH,
+	MEM_IMAGE,
+	MEM_UI,
+	MEM_TILES,
+	MEM_KINDS
+}				t_mem_kind;
+
+typedef enum e_format
+{
+	FDF,
+	PGM,
+	HGT,
+	RAW_INT16,
+	RAW_UINT16,
+	RAW_FLOAT32
+}				t_format;
+
+typedef enum e_sample
+{
+	SAMPLE_U8,
+	SAMPLE_U16_BE,
+	SAMPLE_I16_BE,
+	SAMPLE_I16,
+	SAMPLE_U16,
+	SAMPLE_F32
+}				t_sample;
+
 typedef enum e_color_mode
 {
 	DEFAULT,
@@ -68,6 +215,148 @@ typedef enum e_spin_mode
 	ON
 }				t_spin_mode;
 
+typedef struct s_file
+{
+	char	*data;
+	size_t	size;
+}				t_file;
+
+typedef struct s_verts
+{
+	t_arena				arena;
+	int16_t				*z;
+	atomic_uintptr_t	arrays[VERT_ARRAYS];
+	size_t				elem[VERT_ARRAYS];
+	atomic_int			colors;
+	uint32_t			palette[PALETTE_SIZE];
+	atomic_uchar		hint[PALETTE_SIZE];
+	size_t				count;
+	int					cols;
+}				t_verts;
+
+typedef struct s_post
+{
+	t_vertex	v;
+	uint8_t		out;
+}				t_post;
+
+typedef struct s_batch
+{
+	float		x[BATCH_SIZE];
+	float		z[BATCH_SIZE];
+	uint32_t	color[BATCH_SIZE];
+	t_vec4		base;
+	float		y;
+	int			n;
+}				t_batch;
+
+typedef struct s_lanes
+{
+	float		clip[4][BATCH_LANES];
+	int32_t		s[2][BATCH_LANES];
+	float		depth[BATCH_LANES];
+	int			planes[6];
+}				t_lanes;
+
+typedef struct s_options
+{
+	char		*file;
+	size_t		budget;
+	t_format	format;
+	t_vec2i		dims;
+	bool		mem_report;
+}				t_options;
+
+typedef struct s_memory
+{
+	atomic_size_t	bytes[MEM_KINDS];
+	atomic_size_t	peak[MEM_KINDS];
+}				t_memory;
+
+typedef struct s_cursor
+{
+	const char	*ptr;
+	const char	*end;
+}				t_cursor;
+
+typedef struct s_scan
+{
+	const char	*block;
+	const char	*end;
+	uint64_t	seps;
+	uint64_t	spaces;
+}				t_scan;
+
+typedef struct s_raster
+{
+	const uint8_t	*data;
+	t_vec2i			rows_cols;
+	t_sample		sample;
+}				t_raster;
+
+typedef struct s_cache
+{
+	uint32_t	magic;
+	uint32_t	version;
+	int64_t		src_mtime;
+	int64_t		src_mtime_ns;
+	int64_t		src_size;
+	t_vec2i		rows_cols;
+	t_vec2i		alt_min_max;
+	t_vec3		center;
+	t_vec3		bounds;
+	uint32_t	format;
+	int32_t		colors;
+	uint64_t	size;
+	uint64_t	z;
+	uint64_t	verts[VERT_ARRAYS];
+	uint32_t	palette[PALETTE_SIZE];
+}				t_cache;
+
+typedef struct s_tiles
+{
+	t_file		map;
+	char		*data;
+	t_vec2i		grid;
+	t_vec2i		count;
+	t_vec2i		*alt;
+	int			*prev;
+	int			*next;
+	uint8_t		*flags;
+	int			head;
+	int			tail;
+	size_t		resident;
+	size_t		max_resident;
+	bool		enabled;
+}				t_tiles;
+
+typedef struct s_loader
+{
+	pthread_t		thread;
+	pthread_mutex_t	lock;
+	pthread_cond_t	resized;
+	t_file			file;
+	char			*tmp;
+	t_vec3			center;
+	t_vec3			bounds;
+	bool			boxed;
+	bool			from_cache;
+	bool			stream;
+	int				fd;
+	int				rows;
+	int				cap;
+	int				grow;
+	atomic_int		state;
+	atomic_bool		cancel;
+	atomic_uchar	*ready;
+	t_file			cache;
+	t_vec2i			alt;
+	bool			changed;
+	bool			running;
+	bool			visible;
+	bool			finished;
+}				t_loader;
+
 typedef struct s_cam
 {
 	t_vec3	eye;
@@ -92,68 +381,296 @@ typedef struct s_matrices
 	t_mat4	t;
 	t_mat4	r;
 	t_mat4	s;
+	t_mat4	n;
 	t_mat4	m;
 	t_mat4	v;
 	t_mat4	p;
 	t_mat4	mvp;
+	t_vec4	base;
+	t_vec4	dx;
+	t_vec4	dy;
+	t_vec4	dz;
+	t_vec2i	order;
 }				t_matrices;
 
+typedef struct s_view
+{
+	t_cam			cam;
+	t_transform		transform;
+	t_color_mode	color_mode;
+	t_spin_mode		spin_mode;
+	uint32_t		color1;
+	uint32_t		color2;
+	t_vec2i			size;
+}				t_view;
+
+typedef struct s_segment
+{
+	t_vec2i		s0;
+	t_vec2i		s1;
+	int64_t		depth;
+	int64_t		ddepth;
+	int32_t		t;
+	int32_t		dt;
+	uint32_t	color0;
+	uint32_t	color1;
+}				t_segment;
+
+typedef struct s_span
+{
+	int		index;
+	int		n;
+	int64_t	depth;
+	int64_t	ddepth;
+	int32_t	t;
+	int32_t	dt;
+}				t_span;
+
+typedef struct s_line
+{
+	t_vec2i	d;
+	t_vec2i	s;
+	t_vec2i	p;
+	int		error;
+	int		i;
+	int		n;
+	int		stride;
+	t_span	px;
+}				t_line;
+
+typedef struct s_hiz
+{
+	float		*max;
+	uint16_t	*drawn;
+	uint8_t		*dirty;
+	t_vec2i		size;
+	size_t		bytes;
+}				t_hiz;
+
+typedef struct s_worker
+{
+	pthread_t			thread;
+	struct s_context	*ctx;
+	t_arena				arena;
+	t_arena				bin_arena;
+	t_post				*post;
+	t_segment			*segs;
+	uint32_t			*starts;
+	uint32_t			*bins;
+	size_t				count;
+	size_t				cap;
+	t_vec2i				rows;
+}				t_worker;
+
+typedef struct s_workers
+{
+	t_worker		worker[THREADS_MAX];
+	pthread_mutex_t	lock;
+	pthread_cond_t	start;
+	pthread_cond_t	done;
+	void			*(*routine)(void *);
+	int				threads;
+	int				started;
+	int				running;
+	int				pending;
+	int				job;
+	bool			quit;
+	int				producers;
+	int				bands;
+	int				band_rows;
+	atomic_int		next;
+	atomic_bool		dropped;
+}				t_workers;
+
 typedef struct s_context
 {
 	mlx_t			*mlx;
 	mlx_image_t		*img;
+	char			*file;
 	float			*z_buf;
-	t_vector		*verts;
-	t_vector		*tris;
+	t_hiz			hz;
+	t_verts			verts;
+	t_post			*post;
+	t_arena			frame;
 	t_vec2i			rows_cols;
 	t_vec2i			alt_min_max;
+	t_vec3			o_center;
+	t_vec3			o_bounds;
 	t_vec3			center;
 	t_vec3			bounds;
 	t_transform		transform;
 	t_cam			cam;
 	t_color_mode	color_mode;
 	t_spin_mode		spin_mode;
-	uint32_t		color;
 	uint32_t		color1;
 	uint32_t		color2;
 	double			time_rot;
 	t_matrices		m;
+	t_view			view;
+	t_loader		load;
+	t_tiles			tiles;
+	t_options		opt;
+	t_memory		mem;
+	t_workers		workers;
 }				t_context;
 
-int			parse_map(char *map, t_vector *verts, t_vec2i *rows_cols);
+typedef struct s_chunk
+{
+	pthread_t	thread;
+	t_cursor	cur;
+	t_scan		scan;
+	t_context	*ctx;
+	t_vec2i		alt;
+	int			row;
+	int			rows;
+	bool		joinable;
+	bool		ok;
+}				t_chunk;
+
+typedef struct s_stream
+{
+	t_chunk	chunk;
+	char	*buf;
+	size_t	len;
+	size_t	size;
+	bool	eof;
+}				t_stream;
+
+bool		parse_args(int argc, char **argv, t_options *opt);
+bool		open_map(t_options *opt, t_context *ctx);
+bool		read_cache(t_context *ctx);
+bool		parse_map(t_context *ctx);
+bool		import_map(t_context *ctx);
+bool		open_stream(t_context *ctx);
+bool		stream_map(t_context *ctx);
+bool		reserve_rows(t_context *ctx, t_chunk *chunk);
+bool		grow_rows(t_context *ctx, int cap);
+void		sync_stream(t_context *ctx, int state);
+bool		raster_init(t_context *ctx, t_raster *raster);
+char		*cache_path(char *file);
+void		open_cache(t_context *ctx);
+bool		create_cache(t_context *ctx, t_file *file, size_t size);
+void		finish_cache(t_context *ctx, t_file *file, bool ok);
+bool		write_verts(t_context *ctx, t_cache *head);
+void		map_verts(t_context *ctx);
+bool		verts_valid(t_cache *head);
+int			parse_line(t_chunk *chunk, int row);
+int			count_cols(t_file *file);
+int			split_chunks(t_file *file, t_chunk *chunks);
+bool		run_chunks(t_chunk *chunks, int n, t_context *ctx);
+bool		map_file(char *path, t_file *file);
+void		unmap_file(t_file *file);
+bool		create_file(char *path, size_t size, t_file *file);
+void		drop_pages(void *ptr, size_t size);
+void		init_tiles(t_tiles *tiles, t_vec2i grid, char *data);
+size_t		tiles_size(t_vec2i grid);
+int			tile_index(t_tiles *tiles, t_vec2i pos);
+void		tile_put(t_tiles *tiles, t_vec2i pos, int z, uint32_t color);
+t_vertex	tile_vert(t_tiles *tiles, int tile, t_vec2i pos);
+bool		open_tiles(t_context *ctx);
+void		tile_acquire(t_tiles *tiles, int tile);
+bool		render_tiles(t_context *ctx);
+bool		render_mesh(t_context *ctx);
+void		render_line(t_worker *w, t_post *p0, t_post *p1);
+void		raster_band(t_context *ctx, int band);
+void		draw_segment(t_context *ctx, t_segment *seg, t_vec2i band);
+void		draw_pixel(t_context *ctx, t_segment *seg, t_span *px);
+void		draw_column(t_context *ctx, t_segment *seg, t_line *l,
+				t_vec2i band);
+void		draw_runs(t_context *ctx, t_segment *seg, t_line *l, t_vec2i band);
+void		seek_band(t_line *l, t_vec2i band);
+void		draw_lanes(t_context *ctx, t_segment *seg, t_span *sp);
+bool		alloc_depth(t_context *ctx, int width, int height);
+void		clear_hiz(t_context *ctx);
+void		refresh_hiz(t_context *ctx, t_vec2i rows);
+bool		segment_hidden(t_context *ctx, t_segment *seg);
+void		mark_segment(t_context *ctx, t_segment *seg, int n, t_vec2i band);
+bool		span_visible(t_context *ctx, t_vec2i lo, t_span *sp);
+void		init_workers(t_context *ctx);
+bool		worker_scratch(t_worker *w, size_t cap);
+bool		worker_bins(t_worker *w, size_t total);
+bool		flush_worker(t_worker *w);
+void		free_workers(t_context *ctx);
+void		start_pool(t_context *ctx);
+void		run_workers(t_context *ctx, int n, void *(*routine)(void *));
+void		stop_pool(t_context *ctx);
+void		bin_segments(t_worker *w);
+bool		raster_segments(t_context *ctx, int producers);
+t_post		*post_buffer(t_context *ctx, size_t n);
+void		transform_vert(t_context *ctx, t_vec4 base, t_vertex v,
+				t_post *post);
+void		transform_row(t_context *ctx, int row, t_post *out);
+bool		transform_tile(t_context *ctx, int tile, t_vec2i origin,
+				t_vec2i end);
+void		load_batch(t_context *ctx, t_vec2i pos, t_batch *b);
+void		load_tile_batch(t_context *ctx, int tile, t_vec2i pos,
+				t_batch *b);
+void		transform_batch(t_context *ctx, const t_batch *b, t_post *out);
+void		transform_batch_ref(t_context *ctx, const t_batch *b, int i,
+				t_post *out);
+void		transform_lanes(t_context *ctx, const t_batch *b, int i,
+				t_lanes *l);
+void		scan_init(t_scan *scan, const char *ptr, const char *end);
+const char	*scan_sep(t_scan *scan, const char *ptr);
+const char	*scan_skip(t_scan *scan, const char *ptr);
+void		scan_block(const char *ptr, uint64_t *seps, uint64_t *spaces);
+bool		next_word(t_cursor *elem, t_cursor *word);
+int			parse_int(t_cursor word);
+uint32_t	parse_hex(t_cursor word);
+bool		start_loader(t_context *ctx);
+void		stop_loader(t_context *ctx);
+bool		alloc_rows(t_context *ctx);
+bool		alloc_mesh(t_context *ctx);
+void		publish_row(t_context *ctx, int row, t_vec2i alt);
+bool		row_ready(t_context *ctx, int row);
+bool		update_model(t_context *ctx);
+void		object_bounds(t_context *ctx, t_vec2i alt,
+				t_vec3 *center, t_vec3 *bounds);
+void		box_bounds(t_context *ctx);
 void		resize(int width, int height, void *param);
 void		ft_error(mlx_t *mlx, char *message, t_context *ctx);
-bool		make_triangles(t_vector *tris, t_vec2i rows_cols);
 void		clear_image(t_context *ctx, uint32_t color);
-void		render(void *param);
-void		fdf_free(t_vector *verts, t_vector *tris, t_context *ctx);
+bool		render(t_context *ctx);
+bool		view_changed(t_context *ctx);
+void		fdf_free(t_context *ctx);
 bool		project_to_screen(t_vertex *vert, t_context *ctx);
 void		update_camera(t_cam *cam);
 void		init_camera(t_context *ctx);
 void		update_ui(t_context *ctx);
 void		frame(t_context *ctx);
+void		update_matrices(t_context *ctx);
 void		reset_transforms(t_context *ctx);
 void		control_camera(void *param);
-t_vec3		*make_tri(int x, int y, int z);
 t_mat4		model_matrix(t_context *ctx);
 t_mat4		view_matrix(t_cam cam);
 t_mat4		proj_persp(t_cam cam);
 t_mat4		proj_ortho(t_cam cam);
 uint32_t	rainbow_rgb(double t);
 uint32_t	lerp_color(uint32_t c1, uint32_t c2, float t);
-t_vertex	*make_vert(float x, float y, float z, uint32_t color);
+uint32_t	abgr_color(uint32_t c);
+bool		make_vert(t_context *ctx, t_vec2i pos, int z, uint32_t color);
+bool		verts_alloc(t_verts *verts, int rows, int cols);
+bool		verts_copy(t_verts *dst, t_verts *src, size_t n);
+void		verts_free(t_verts *verts);
+int			vert_z(t_verts *verts, size_t i);
+uint32_t	vert_color(t_verts *verts, size_t i);
+bool		vert_put(t_context *ctx, size_t i, int z, uint32_t color);
 int			wrap_m_x(t_context *ctx, t_vec2i *pos);
 int			wrap_m_y(t_context *ctx, t_vec2i *pos);
 void		key_hook(mlx_key_data_t keydata, void *param);
 void		translate_rotate(t_context *ctx);
-void		compute_bounds(t_context *ctx, t_space space,
-				size_t i, t_vertex *v);
-void		initialize(char *file, t_context **ctx,
+void		initialize(t_options *opt, t_context **ctx,
 				mlx_t *mlx, mlx_image_t *img);
 bool		liang_barsky_clip(t_vertex *v0, t_vertex *v1);
 bool		liang_barsky_screen(t_context *ctx, t_vertex *v0, t_vertex *v1);
-bool		depth_test(t_context *ctx, t_vertex v0, t_vertex v1, t_vec3 t);
+void		segment_steps(t_context *ctx, t_segment *seg, t_vertex *v0,
+				t_vertex *v1);
 void		control_fov(t_context *ctx);
 void		compute_distance(t_context *ctx);
+void		memory_track(t_context *ctx, t_mem_kind kind, ssize_t bytes);
+mlx_image_t	*memory_image(t_context *ctx, mlx_image_t *img, t_mem_kind kind);
+void		memory_delete_image(t_context *ctx, mlx_image_t **img,
+				t_mem_kind kind);
+void		memory_report(t_context *ctx);
 
 #endif
@@ -6,7 +6,7 @@
 /*   By: myli-pen <myli-pen@student.hive.fi>        +#+  +:+       +#+        */
 /*                                                +#+#+#+#+#+   +#+           */
 /*   Created: 2025/07/02 14:42:24 by myli-pen          #+#    #+#             */
-/*   Updated: 2025/07/16 22:51:56 by myli-pen         ###   ########.fr       */
+/*   Updated: 2026/10/18 00:30:47 by myli-pen         ###   ########.fr       */
 /*                                                                            */
 /* ************************************************************************** */
 
@@ -15,6 +15,13 @@
 
 # include "libft_defs.h"
 
+typedef struct s_arena
+{
+	char	*data;
+	size_t	size;
+	size_t	used;
+}				t_arena;
+
 void	*ft_bzero(void *s, size_t n);
 void	*ft_calloc(size_t nmemb, size_t size);
 void	*ft_memchr(const void *s, int c, size_t n);
@@ -22,5 +29,9 @@ void	*ft_memset(void *s, int c, size_t n);
 void	*ft_memcpy(void *dest, const void *src, size_t n);
 void	*ft_memmove(void *dest, const void *src, size_t n);
 int		ft_memcmp(const void *s1, const void *s2, size_t n);
+bool	ft_arena_init(t_arena *arena, size_t size);
+void	*ft_arena_alloc(t_arena *arena, size_t size, size_t align);
+void	ft_arena_reset(t_arena *arena);
+void	ft_arena_free(t_arena *arena);
 
 #endif
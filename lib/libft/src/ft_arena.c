@@ -0,0 +1,83 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   ft_arena.c                                         :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: myli-pen <myli-pen@student.hive.fi>        +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/18 00:22:37 by myli-pen          #+#    #+#             */
+/*   Updated: 2026/10/18 00:22:37 by myli-pen         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include <sys/mman.h>
+
+#include "libft_mem.h"
+
+/**
+ * Reserves a contiguous arena of `size` bytes to bump allocate from.
+ *
+ * The arena is mapped anonymously, so its pages are zeroed and only take
+ * memory once they are written: an arena can be reserved for the largest
+ * size it may need, and the memory allocated from a fresh arena is zeroed.
+ *
+ * @param arena Arena to initialize, `data` is NULL on failure.
+ * @param size Size of the arena in bytes.
+ * @return True if successful, else false.
+ */
+bool	ft_arena_init(t_arena *arena, size_t size)
+{
+	arena->data = mmap(NULL, size, PROT_READ | PROT_WRITE,
+			MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+	if (arena->data == MAP_FAILED)
+		arena->data = NULL;
+	arena->size = size * (arena->data != NULL);
+	arena->used = 0;
+	return (arena->data != NULL);
+}
+
+/**
+ * Allocates `size` bytes from the arena in constant time, by bumping its
+ * offset past them. The memory is only given back by `ft_arena_reset()` or
+ * `ft_arena_free()`, all at once.
+ *
+ * @param arena Arena to allocate from.
+ * @param size Size of the allocation in bytes.
+ * @param align Alignment of the allocation, a power of two.
+ * @return Pointer to the allocated memory, or NULL if the arena is full.
+ */
+void	*ft_arena_alloc(t_arena *arena, size_t size, size_t align)
+{
+	size_t	offset;
+
+	offset = (arena->used + align - 1) & ~(align - 1);
+	if (!arena->data || offset > arena->size || size > arena->size - offset)
+		return (NULL);
+	arena->used = offset + size;
+	return (arena->data + offset);
+}
+
+/**
+ * Gives back every allocation of the arena at once, keeping it reserved.
+ * The memory allocated again is not zeroed.
+ *
+ * @param arena Arena to reset.
+ */
+void	ft_arena_reset(t_arena *arena)
+{
+	arena->used = 0;
+}
+
+/**
+ * Releases the arena and every allocation from it with a single unmap.
+ *
+ * @param arena Arena to release, may be zeroed or failed to initialize.
+ */
+void	ft_arena_free(t_arena *arena)
+{
+	if (arena->data)
+		munmap(arena->data, arena->size);
+	arena->data = NULL;
+	arena->size = 0;
+	arena->used = 0;
+}
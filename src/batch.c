@@ -0,0 +1,157 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   batch.c                                            :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: myli-pen <myli-pen@student.hive.fi>        +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/18 01:03:36 by myli-pen          #+#    #+#             */
+/*   Updated: 2026/10/18 01:03:36 by myli-pen         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "fdf.h"
+
+static inline void	store_lanes(const t_batch *b, int i, t_lanes *l,
+						t_post *out);
+
+/**
+ * Loads a batch of up to BATCH_SIZE vertices of a row of the vertex store,
+ * as separate arrays of columns, heights and colors, along with the
+ * clip-space position of column 0 at height 0 of the row.
+ *
+ * @param ctx Rendering context with the grid deltas of the frame.
+ * @param pos Column (x) and row (y) of the first vertex.
+ * @param b Out batch.
+ */
+void	load_batch(t_context *ctx, t_vec2i pos, t_batch *b)
+{
+	size_t	i;
+	int		k;
+
+	b->n = ft_imin(BATCH_SIZE, ctx->rows_cols.y - pos.x);
+	b->y = -(float)pos.y;
+	b->base = vec4_add(ctx->m.base, vec4_scale(ctx->m.dy, pos.y));
+	i = (size_t)pos.y * ctx->verts.cols + pos.x;
+	k = -1;
+	while (++k < b->n)
+	{
+		b->x[k] = pos.x + k;
+		b->z[k] = vert_z(&ctx->verts, i + k);
+		b->color[k] = vert_color(&ctx->verts, i + k);
+	}
+}
+
+/**
+ * Loads a batch of `b->n` vertices of a row of a resident tile, like
+ * `load_batch()`. A tile row fits in a batch, as TILE_SIZE <= BATCH_SIZE.
+ *
+ * @param ctx Rendering context with the grid deltas of the frame.
+ * @param tile Index of the tile.
+ * @param pos Column (x) and row (y) of the first vertex.
+ * @param b Batch with its size set, out vertices.
+ */
+void	load_tile_batch(t_context *ctx, int tile, t_vec2i pos, t_batch *b)
+{
+	t_vertex	v;
+	int			k;
+
+	b->y = -(float)pos.y;
+	b->base = vec4_add(ctx->m.base, vec4_scale(ctx->m.dy, pos.y));
+	k = -1;
+	while (++k < b->n)
+	{
+		v = tile_vert(&ctx->tiles, tile, vec2i(pos.x + k, pos.y));
+		b->x[k] = v.pos.x;
+		b->z[k] = v.pos.z;
+		b->color[k] = v.color;
+	}
+}
+
+/**
+ * Transforms a batch of vertices, BATCH_LANES at a time with
+ * `transform_lanes()`, the remainder with the scalar reference.
+ * Both give the same results bit for bit.
+ *
+ * @param ctx Rendering context with the grid deltas of the frame.
+ * @param b Batch of vertices.
+ * @param out Out transformed vertices, one per vertex of the batch.
+ */
+void	transform_batch(t_context *ctx, const t_batch *b, t_post *out)
+{
+	t_lanes	l;
+	int		i;
+
+	i = 0;
+	while (i + BATCH_LANES <= b->n)
+	{
+		transform_lanes(ctx, b, i, &l);
+		store_lanes(b, i, &l, out);
+		i += BATCH_LANES;
+	}
+	transform_batch_ref(ctx, b, i, out);
+}
+
+/**
+ * Scalar reference of `transform_batch()`, transforming the vertices of a
+ * batch from index `i` one at a time with `transform_vert()`.
+ *
+ * @param ctx Rendering context with the grid deltas of the frame.
+ * @param b Batch of vertices.
+ * @param i Index of the first vertex.
+ * @param out Out transformed vertices, one per vertex of the batch.
+ */
+void	transform_batch_ref(t_context *ctx, const t_batch *b, int i,
+			t_post *out)
+{
+	t_vertex	v;
+
+	v.s = vec2i(0, 0);
+	v.depth = 0.0f;
+	i--;
+	while (++i < b->n)
+	{
+		v.pos = vec4(b->x[i], b->y, b->z[i], 1.0f);
+		v.color = b->color[i];
+		transform_vert(ctx, b->base, v, &out[i]);
+	}
+}
+
+/**
+ * Scatters the lanes of `transform_lanes()` into transformed vertices,
+ * gathering the outcode of each lane from the masks of the planes.
+ * Vertices outside the view frustum keep no screen position nor depth,
+ * like with `transform_vert()`.
+ *
+ * @param b Batch of vertices.
+ * @param i Index of the vertex of lane 0.
+ * @param l Transformed lanes.
+ * @param out Out transformed vertices, one per vertex of the batch.
+ */
+static inline void	store_lanes(const t_batch *b, int i, t_lanes *l,
+						t_post *out)
+{
+	t_post	*p;
+	int		k;
+	int		j;
+
+	k = -1;
+	while (++k < BATCH_LANES)
+	{
+		p = &out[i + k];
+		p->out = 0;
+		j = -1;
+		while (++j < 6)
+			p->out |= ((l->planes[j] >> k) & 1) << j;
+		p->v.pos = vec4(l->clip[0][k], l->clip[1][k], l->clip[2][k],
+				l->clip[3][k]);
+		p->v.o_pos = vec4(b->x[i + k], b->y, b->z[i + k], 1.0f);
+		p->v.color = b->color[i + k];
+		p->v.s = vec2i(0, 0);
+		p->v.depth = 0.0f;
+		if (p->out)
+			continue ;
+		p->v.s = vec2i(l->s[0][k], l->s[1][k]);
+		p->v.depth = l->depth[k];
+	}
+}
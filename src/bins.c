@@ -0,0 +1,143 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   bins.c                                             :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: myli-pen <myli-pen@student.hive.fi>        +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/18 00:43:39 by myli-pen          #+#    #+#             */
+/*   Updated: 2026/10/18 04:04:16 by myli-pen         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "fdf.h"
+
+static inline size_t	count_bins(t_worker *w);
+static inline t_vec2i	segment_bands(t_segment *seg, int rows);
+static void				*raster_bands(void *param);
+
+/**
+ * Bins the segments of a worker by the bands of rows of the image
+ * they cross, keeping the order they were emitted in. A segment crossing
+ * several bands is listed in each of them.
+ *
+ * The segments of band `b` are `bins[starts[b]]` to `bins[starts[b + 1]]`
+ * (excluded). The bins are sized from the counts (see `worker_bins()`), the
+ * batch is dropped if they cannot be allocated, which `raster_segments()`
+ * reports.
+ *
+ * @param w Worker with its segments emitted.
+ */
+void	bin_segments(t_worker *w)
+{
+	t_vec2i	b;
+	size_t	i;
+	int		bands;
+
+	bands = w->ctx->workers.bands;
+	if (!worker_bins(w, count_bins(w)))
+	{
+		ft_bzero(w->starts, (bands + 1) * sizeof(uint32_t));
+		atomic_store(&w->ctx->workers.dropped, true);
+		return ;
+	}
+	i = -1;
+	while (++i < w->count)
+	{
+		b = segment_bands(&w->segs[i], w->ctx->workers.band_rows);
+		while (b.x <= b.y)
+			w->bins[w->starts[b.x++]++] = i;
+	}
+	ft_memmove(w->starts + 1, w->starts, bands * sizeof(uint32_t));
+	w->starts[0] = 0;
+}
+
+/**
+ * Draws the segments binned by the first `producers` workers. The bands of
+ * the image are handed out to the workers one at a time, and each worker
+ * only writes the pixels and the Z-buffer of its bands, so no locks are
+ * needed. Within a band, the segments are drawn in the order of the
+ * workers, then in the order each emitted them, which is the order of a
+ * single threaded frame, giving the same pixels.
+ *
+ * @param ctx Rendering context.
+ * @param producers Number of workers holding binned segments.
+ * @return `true` if every segment was drawn, `false` if segments were
+ * dropped since the last call (see `bin_segments()` and `transform_tile()`).
+ */
+bool	raster_segments(t_context *ctx, int producers)
+{
+	ctx->workers.producers = producers;
+	atomic_store(&ctx->workers.next, 0);
+	run_workers(ctx, ft_imin(ctx->workers.threads, ctx->workers.bands),
+		raster_bands);
+	return (!atomic_exchange(&ctx->workers.dropped, false));
+}
+
+/**
+ * Counts the segments of every band into `starts`, and turns the counts
+ * into the offsets of the ends of the previous bands in `bins`.
+ *
+ * @param w Worker with its segments emitted.
+ * @return Number of segments over every band.
+ */
+static inline size_t	count_bins(t_worker *w)
+{
+	t_vec2i	b;
+	size_t	i;
+	size_t	total;
+
+	w->starts = ft_arena_alloc(&w->arena,
+			(w->ctx->workers.bands + 1) * sizeof(uint32_t), VERT_ALIGN);
+	ft_bzero(w->starts, (w->ctx->workers.bands + 1) * sizeof(uint32_t));
+	i = -1;
+	while (++i < w->count)
+	{
+		b = segment_bands(&w->segs[i], w->ctx->workers.band_rows);
+		while (b.x <= b.y)
+			++w->starts[b.x++];
+	}
+	total = 0;
+	i = -1;
+	while (++i <= (size_t)w->ctx->workers.bands)
+	{
+		b.x = w->starts[i];
+		w->starts[i] = total;
+		total += b.x;
+	}
+	return (total);
+}
+
+/**
+ * Returns the first (x) and last (y) band crossed by a segment.
+ *
+ * @param seg Segment in screen space.
+ * @param rows Rows of a band.
+ * @return Range of bands.
+ */
+static inline t_vec2i	segment_bands(t_segment *seg, int rows)
+{
+	return (vec2i(ft_imin(seg->s0.y, seg->s1.y) / rows,
+			ft_imax(seg->s0.y, seg->s1.y) / rows));
+}
+
+/**
+ * Thread routine of `raster_segments()`, drawing bands until none is left.
+ *
+ * @param param Worker.
+ * @return NULL.
+ */
+static void	*raster_bands(void *param)
+{
+	t_context	*ctx;
+	int			band;
+
+	ctx = ((t_worker *)param)->ctx;
+	band = atomic_fetch_add(&ctx->workers.next, 1);
+	while (band < ctx->workers.bands)
+	{
+		raster_band(ctx, band);
+		band = atomic_fetch_add(&ctx->workers.next, 1);
+	}
+	return (NULL);
+}
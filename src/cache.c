@@ -0,0 +1,163 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   cache.c                                            :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: myli-pen <myli-pen@student.hive.fi>        +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/17 22:30:30 by myli-pen          #+#    #+#             */
+/*   Updated: 2026/10/18 03:57:54 by myli-pen         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "fdf.h"
+
+static inline bool	cache_valid(t_context *ctx, t_file *cache);
+static inline bool	load_row(t_context *ctx, t_tiles *tiles, int row);
+
+/**
+ * Opens the map for the loader, preferring the binary cache next to it.
+ *
+ * Both files are only mapped here, so a missing or unreadable map is
+ * reported before the window opens. The vertices are loaded later on the
+ * loader thread by `read_cache()`, `parse_map()` or `import_map()`.
+ * The standard input and FIFOs are streamed instead, without a cache, and
+ * only in the FdF text format.
+ *
+ * @param opt Command line options with the path to the map file.
+ * @param ctx Rendering context receiving the options and the mapped file.
+ * @return `true` on success, `false` if the map cannot be opened.
+ */
+bool	open_map(t_options *opt, t_context *ctx)
+{
+	char	*path;
+
+	ctx->opt = *opt;
+	ctx->file = opt->file;
+	ctx->load.file = (t_file){NULL, 0};
+	ctx->load.from_cache = false;
+	if (open_stream(ctx))
+		return (ctx->load.fd >= 0 && opt->format == FDF);
+	path = cache_path(opt->file);
+	if (path && map_file(path, &ctx->load.file) &&
+		cache_valid(ctx, &ctx->load.file))
+		ctx->load.from_cache = true;
+	free(path);
+	if (ctx->load.from_cache)
+		return (true);
+	unmap_file(&ctx->load.file);
+	return (map_file(opt->file, &ctx->load.file));
+}
+
+/**
+ * Returns the cache path of a map, e.g. "maps/42.fdf" -> "maps/42.fdfc".
+ * Maps without the `.fdf` extension get CACHE_EXT appended.
+ *
+ * @param file Path to the map file.
+ * @return Allocated cache path, or NULL on allocation failure.
+ */
+char	*cache_path(char *file)
+{
+	size_t	len;
+
+	len = ft_strlen(file);
+	if (len >= 4 && !ft_strncmp(file + len - 4, ".fdf", 4))
+		return (ft_strjoin(file, "c"));
+	return (ft_strjoin(file, CACHE_EXT));
+}
+
+/**
+ * Loads the vertices from the mapped cache, publishing them row by row like
+ * the parser does. The vertex store is drawn from the cache as is when the
+ * cache holds it (see `map_verts()`), and maps drawn out of core keep their
+ * vertices in the tiles, so their rows are published right away. Otherwise
+ * the vertices are decoded from the tiles. The altitude range and the
+ * object-space bounds are taken from the header.
+ *
+ * @param ctx Rendering context with the cache mapped by `open_map()`.
+ * @return `true` on success, `false` on allocation failure or cancellation.
+ */
+bool	read_cache(t_context *ctx)
+{
+	t_cache	*head;
+	int		row;
+
+	head = (t_cache *)ctx->load.file.data;
+	ctx->rows_cols = head->rows_cols;
+	ctx->load.center = head->center;
+	ctx->load.bounds = head->bounds;
+	ctx->load.boxed = true;
+	init_tiles(&ctx->tiles, head->rows_cols, ctx->load.file.data + TILE_DATA);
+	if (!alloc_rows(ctx))
+		return (false);
+	row = -1;
+	while (++row < ctx->rows_cols.x)
+	{
+		if (atomic_load(&ctx->load.cancel) || (ctx->load.file.data &&
+				!load_row(ctx, &ctx->tiles, row)))
+			return (false);
+		publish_row(ctx, row, head->alt_min_max);
+	}
+	return (true);
+}
+
+/**
+ * Checks that a mapped cache was written by this version for the current
+ * contents of the map, keyed by its modification time, to the nanosecond,
+ * and its size, read in the same format and with the same dimensions for
+ * raw maps, and that it is complete. Caches holding a vertex store (see
+ * `write_verts()`) have no tiles, so they are only used by maps drawn in
+ * core.
+ *
+ * @param ctx Rendering context with the options.
+ * @param cache Mapped cache file.
+ * @return `true` if the cache can be used.
+ */
+static inline bool	cache_valid(t_context *ctx, t_file *cache)
+{
+	struct stat	st;
+	t_cache		*head;
+
+	head = (t_cache *)cache->data;
+	if (stat(ctx->file, &st) == ERROR || cache->size < sizeof(t_cache))
+		return (false);
+	if (head->magic != CACHE_MAGIC || head->version != CACHE_VERSION ||
+		head->src_mtime != st.st_mtim.tv_sec ||
+		head->src_mtime_ns != st.st_mtim.tv_nsec ||
+		head->src_size != st.st_size ||
+		head->format != ctx->opt.format ||
+		head->rows_cols.x < 2 || head->rows_cols.y < 2)
+		return (false);
+	if (ctx->opt.dims.x && (head->rows_cols.x != ctx->opt.dims.x ||
+			head->rows_cols.y != ctx->opt.dims.y))
+		return (false);
+	if (cache->size != head->size)
+		return (false);
+	if (head->z)
+		return ((size_t)head->rows_cols.x * head->rows_cols.y * VERT_SIZE <=
+			ctx->opt.budget && verts_valid(head));
+	return (head->size >= tiles_size(head->rows_cols));
+}
+
+/**
+ * Creates the vertices of one row from the tiles of the cache.
+ *
+ * @param ctx Rendering context.
+ * @param tiles Tiles of the mapped cache.
+ * @param row Row index.
+ * @return `true` on success, `false` on allocation failure.
+ */
+static inline bool	load_row(t_context *ctx, t_tiles *tiles, int row)
+{
+	t_vertex	v;
+	t_vec2i		pos;
+
+	pos = vec2i(-1, row);
+	while (++pos.x < tiles->grid.y)
+	{
+		v = tile_vert(tiles, tile_index(tiles, pos), pos);
+		if (!make_vert(ctx, pos, v.pos.z, v.color))
+			return (false);
+	}
+	return (true);
+}
@@ -0,0 +1,142 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   cache_verts.c                                      :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: myli-pen <myli-pen@student.hive.fi>        +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/18 02:58:33 by myli-pen          #+#    #+#             */
+/*   Updated: 2026/10/18 03:57:54 by myli-pen         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "fdf.h"
+
+static inline bool		write_array(int fd, void *data, size_t bytes,
+							uint64_t *off);
+
+/**
+ * Appends the vertex store of the parsed map to its cache, after the header,
+ * in the layout the renderer reads: the int16 heights, then each optional
+ * array the map needed (see `verts_alloc()`), every one aligned to
+ * VERT_ALIGN. Their offsets and the size of the file are kept in the header,
+ * for `map_verts()` to draw from the mapped cache. Maps drawn out of core
+ * have no store, only tiles (see `open_tiles()`).
+ *
+ * @param ctx Rendering context containing the vertex store.
+ * @param head Header of the cache, mapped writable, with its size set and
+ * no arrays.
+ * @return `true` on success, `false` on failure.
+ */
+bool	write_verts(t_context *ctx, t_cache *head)
+{
+	void	*data;
+	bool	ok;
+	int		fd;
+	int		k;
+
+	if (ctx->tiles.enabled || !ctx->verts.z)
+		return (true);
+	fd = open(ctx->load.tmp, O_WRONLY);
+	head->z = head->size;
+	ok = fd != ERROR && write_array(fd, ctx->verts.z,
+			ctx->verts.count * sizeof(int16_t), &head->size);
+	k = -1;
+	while (ok && ++k < VERT_ARRAYS)
+	{
+		data = (void *)atomic_load(&ctx->verts.arrays[k]);
+		if (data)
+			head->verts[k] = head->size;
+		ok = !data || write_array(fd, data,
+				ctx->verts.count * ctx->verts.elem[k], &head->size);
+	}
+	if (fd != ERROR)
+		close(fd);
+	return (ok);
+}
+
+/**
+ * Sets the vertex store up straight on the arrays of a mapped cache holding
+ * them (see `verts_valid()`), instead of decoding every vertex. The mapping
+ * becomes the arena of the store, unmapped by `verts_free()`, and is only
+ * read, like any vertex store once loaded.
+ *
+ * @param ctx Rendering context with the cache mapped by `open_map()`.
+ */
+void	map_verts(t_context *ctx)
+{
+	t_cache	*head;
+	t_verts	*verts;
+	int		k;
+
+	head = (t_cache *)ctx->load.file.data;
+	verts = &ctx->verts;
+	verts->count = (size_t)head->rows_cols.x * head->rows_cols.y;
+	verts->cols = head->rows_cols.y;
+	verts->elem[VERT_WIDE] = sizeof(int32_t);
+	verts->elem[VERT_INDEX] = sizeof(uint8_t);
+	verts->elem[VERT_COLOR] = sizeof(uint32_t);
+	verts->z = (int16_t *)(ctx->load.file.data + head->z);
+	k = -1;
+	while (++k < VERT_ARRAYS)
+		atomic_init(&verts->arrays[k], 0);
+	while (--k >= 0)
+		if (head->verts[k])
+			atomic_init(&verts->arrays[k], (uintptr_t)head + head->verts[k]);
+	atomic_init(&verts->colors, head->colors);
+	ft_memcpy(verts->palette, head->palette, sizeof(verts->palette));
+	ft_memset(verts->hint, 0, sizeof(verts->hint));
+	verts->arena = (t_arena){ctx->load.file.data, head->size, head->size};
+	madvise(verts->z, head->size - head->z, MADV_WILLNEED);
+	memory_track(ctx, MEM_VERTS, head->size - head->z);
+	ctx->load.file = (t_file){NULL, 0};
+}
+
+/**
+ * Checks that the arrays of a cache holding a vertex store lie aligned
+ * inside of it, after its header.
+ *
+ * @param head Header of the mapped cache, with `size` checked against it.
+ * @return `true` if the store can be mapped by `map_verts()`.
+ */
+bool	verts_valid(t_cache *head)
+{
+	size_t	count;
+	size_t	elem[VERT_ARRAYS];
+	int		k;
+
+	count = (size_t)head->rows_cols.x * head->rows_cols.y;
+	elem[VERT_WIDE] = sizeof(int32_t);
+	elem[VERT_INDEX] = sizeof(uint8_t);
+	elem[VERT_COLOR] = sizeof(uint32_t);
+	if (head->z < sizeof(t_cache) || head->z % VERT_ALIGN ||
+		head->colors < 1 || head->colors > COLOR_ESC ||
+		head->z + count * sizeof(int16_t) > head->size)
+		return (false);
+	k = -1;
+	while (++k < VERT_ARRAYS)
+		if (head->verts[k] && (head->verts[k] < head->z ||
+				head->verts[k] % VERT_ALIGN ||
+				head->verts[k] + count * elem[k] > head->size))
+			return (false);
+	return (true);
+}
+
+/**
+ * Writes an array of the vertex store at an offset of the cache file.
+ *
+ * @param fd Cache file, open for writing.
+ * @param data Array to write.
+ * @param bytes Size of the array in bytes.
+ * @param off Offset to write at, moved past the array, aligned, which the
+ * file is padded to.
+ * @return `true` on success, `false` on failure.
+ */
+static inline bool	write_array(int fd, void *data, size_t bytes,
+						uint64_t *off)
+{
+	if (pwrite(fd, data, bytes, *off) != (ssize_t)bytes)
+		return (false);
+	*off = (*off + bytes + VERT_ALIGN - 1) & ~(uint64_t)(VERT_ALIGN - 1);
+	return (ftruncate(fd, *off) != ERROR);
+}
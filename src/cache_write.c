@@ -0,0 +1,99 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   cache_write.c                                      :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: myli-pen <myli-pen@student.hive.fi>        +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/17 22:30:30 by myli-pen          #+#    #+#             */
+/*   Updated: 2026/10/18 04:07:35 by myli-pen         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "fdf.h"
+
+/**
+ * Creates the binary cache of a map about to be parsed into the mesh next
+ * to the map file.
+ *
+ * The cache holds a header with the dimensions, the altitude range and the
+ * object-space bounds, followed by the vertex store of the map as the
+ * renderer reads it (see `write_verts()`), both written by `finish_cache()`
+ * once every row has been parsed. Maps too large for a mesh get a cache of
+ * tiles instead, drawn straight from (see `open_tiles()`). Failing to create
+ * the cache, e.g. in a read-only directory, is not an error, the map is only
+ * parsed into the mesh then.
+ *
+ * @param ctx Rendering context with `rows_cols` set.
+ */
+void	open_cache(t_context *ctx)
+{
+	ft_bzero(&ctx->load.cache, sizeof(t_file));
+	create_cache(ctx, &ctx->load.cache, (sizeof(t_cache) + VERT_ALIGN - 1) &
+		~(size_t)(VERT_ALIGN - 1));
+}
+
+/**
+ * Creates a temporary cache file of the given size, and maps it writable,
+ * e.g. for the tiles of the map to be stored into. The file gets a unique
+ * name next to the cache, kept in `ctx->load.tmp` for `finish_cache()`, so
+ * several instances loading the same map never write to the same file.
+ *
+ * @param ctx Rendering context with `rows_cols` set.
+ * @param file Out writable mapping of the cache.
+ * @param size Size of the file in bytes.
+ * @return `true` on success, `false` on failure.
+ */
+bool	create_cache(t_context *ctx, t_file *file, size_t size)
+{
+	char	*path;
+
+	path = cache_path(ctx->file);
+	ctx->load.tmp = NULL;
+	if (path)
+		ctx->load.tmp = ft_strjoin(path, ".XXXXXX");
+	free(path);
+	if (ctx->load.tmp &&
+		create_file(ctx->load.tmp, size, file))
+		return (true);
+	free(ctx->load.tmp);
+	ctx->load.tmp = NULL;
+	return (false);
+}
+
+/**
+ * Completes a cache created by `create_cache()` once the map is parsed,
+ * appending the vertex store (see `write_verts()`). The header is written
+ * last and the file is renamed into place, so
+ * a concurrent reader never sees a partial cache. An incomplete cache is
+ * removed instead. The mapping stays valid in both cases.
+ *
+ * @param ctx Rendering context containing the model.
+ * @param file Writable mapping of the cache.
+ * @param ok `true` if every tile has been stored.
+ */
+void	finish_cache(t_context *ctx, t_file *file, bool ok)
+{
+	t_cache		*head;
+	struct stat	st;
+	char		*path;
+
+	path = cache_path(ctx->file);
+	ok = ok && path && ctx->load.tmp && stat(ctx->file, &st) != ERROR;
+	if (ok)
+	{
+		head = (t_cache *)file->data;
+		*head = (t_cache){CACHE_MAGIC, CACHE_VERSION, st.st_mtim.tv_sec,
+			st.st_mtim.tv_nsec, st.st_size, ctx->rows_cols, ctx->load.alt,
+			vec3_n(0.0f), vec3_n(0.0f), ctx->opt.format,
+			atomic_load(&ctx->verts.colors), file->size, 0, {0}, {0}};
+		ft_memcpy(head->palette, ctx->verts.palette, sizeof(head->palette));
+		object_bounds(ctx, ctx->load.alt, &head->center, &head->bounds);
+		ok = write_verts(ctx, head) && rename(ctx->load.tmp, path) != ERROR;
+	}
+	if (!ok && ctx->load.tmp)
+		unlink(ctx->load.tmp);
+	free(path);
+	free(ctx->load.tmp);
+	ctx->load.tmp = NULL;
+}
@@ -6,7 +6,7 @@
 /*   By: myli-pen <myli-pen@student.hive.fi>        +#+  +:+       +#+        */
 /*                                                +#+#+#+#+#+   +#+           */
 /*   Created: 2025/07/18 13:45:24 by myli-pen          #+#    #+#             */
-/*   Updated: 2025/07/29 20:04:46 by myli-pen         ###   ########.fr       */
+/*   Updated: 2026/10/18 02:44:35 by myli-pen         ###   ########.fr       */
 /*                                                                            */
 /* ************************************************************************** */
 
@@ -15,7 +15,10 @@
 /**
  * Positions and updates the camera to frame the entire model within view.
  *
- * - Computes the model bounds in WORLD space.
+ * - Computes the model bounds in WORLD space from the eight corners of the
+ * object-space bounding box, in constant time for any map size. The box is
+ * conservative, it contains every vertex, but may be larger than the
+ * vertices once rotated.
  *
  * - Updates the camera's aspect ratio based on the current window size.
  *
@@ -25,15 +28,17 @@
  *
  * - Calls `update_camera()` to apply pitch, yaw, and distance.
  *
+ * Does nothing until the loader has published the first row.
+ *
  * @param ctx Rendering context containing the model and camera.
  */
 void	frame(t_context *ctx)
 {
-	t_vertex	v;
-
+	if (!ctx->load.visible)
+		return ;
 	ctx->cam.aspect = (float)ctx->img->width / ctx->img->height;
 	ctx->m.m = model_matrix(ctx);
-	compute_bounds(ctx, WORLD, 0, &v);
+	box_bounds(ctx);
 	ctx->cam.target = ctx->center;
 	compute_distance(ctx);
 	update_camera(&ctx->cam);
@@ -112,3 +117,35 @@ void	compute_distance(t_context *ctx)
 		ctx->cam.distance = max_dim;
 	}
 }
+
+/**
+ * Builds the model, view, and projection matrices for the current frame,
+ * and combines them into the MVP matrix.
+ *
+ * Vertex (col, row) of the grid lies at (col, -row, height) in object space,
+ * so its clip-space position is `base + col * dx + row * dy + height * dz`.
+ * The four vectors are the columns of the MVP matrix, with dy negated.
+ *
+ * The depth of the vertices grows with `z + w` in clip space, for both
+ * projections, so its sign along dx and dy gives the order of the columns
+ * (x) and rows (y) from front to back: 1 going up, -1 going down. The grid
+ * is drawn in that order, for the hierarchical Z-buffer to reject as many
+ * hidden lines as it can (see `segment_hidden()` and `span_visible()`).
+ *
+ * @param ctx Rendering context containing the transform and camera.
+ */
+void	update_matrices(t_context *ctx)
+{
+	ctx->m.m = model_matrix(ctx);
+	ctx->m.v = view_matrix(ctx->cam);
+	ctx->m.p = proj_ortho(ctx->cam);
+	if (ctx->cam.projection == PERSPECTIVE)
+		ctx->m.p = proj_persp(ctx->cam);
+	ctx->m.mvp = mat4_mul(mat4_mul(ctx->m.p, ctx->m.v), ctx->m.m);
+	ctx->m.base = mat4_mul_vec4(ctx->m.mvp, vec4(0.0f, 0.0f, 0.0f, 1.0f));
+	ctx->m.dx = mat4_mul_vec4(ctx->m.mvp, vec4(1.0f, 0.0f, 0.0f, 0.0f));
+	ctx->m.dy = mat4_mul_vec4(ctx->m.mvp, vec4(0.0f, -1.0f, 0.0f, 0.0f));
+	ctx->m.dz = mat4_mul_vec4(ctx->m.mvp, vec4(0.0f, 0.0f, 1.0f, 0.0f));
+	ctx->m.order = vec2i(1 - 2 * (ctx->m.dx.z + ctx->m.dx.w < 0.0f),
+			1 - 2 * (ctx->m.dy.z + ctx->m.dy.w < 0.0f));
+}
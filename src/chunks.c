@@ -0,0 +1,158 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   chunks.c                                           :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: myli-pen <myli-pen@student.hive.fi>        +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/17 22:28:57 by myli-pen          #+#    #+#             */
+/*   Updated: 2026/10/17 23:53:29 by myli-pen         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "fdf.h"
+
+static inline int			thread_count(size_t size);
+static inline const char	*next_line(const char *ptr, const char *end);
+static void					*parse_chunk(void *param);
+
+/**
+ * Splits a mapped map file on newline boundaries into row ranges of roughly
+ * equal size, one per parser thread, and counts the rows on the way.
+ *
+ * Files smaller than PARSE_MT_SIZE are kept in a single range.
+ *
+ * @param file Mapped map file.
+ * @param chunks Out array of at least THREADS_MAX row ranges.
+ * @return Number of row ranges.
+ */
+int	split_chunks(t_file *file, t_chunk *chunks)
+{
+	const char	*ptr;
+	const char	*end;
+	int			n;
+	int			k;
+	int			row;
+
+	n = thread_count(file->size);
+	ptr = file->data;
+	end = file->data + file->size;
+	row = 0;
+	k = -1;
+	while (++k < n)
+	{
+		chunks[k].cur.ptr = ptr;
+		chunks[k].row = row;
+		while (ptr < end && ptr < file->data + file->size * (k + 1) / n)
+		{
+			ptr = next_line(ptr, end);
+			++row;
+		}
+		chunks[k].cur.end = ptr;
+		chunks[k].rows = row - chunks[k].row;
+	}
+	return (n);
+}
+
+/**
+ * Parses every row range into its slice of the vertex vector. The first
+ * range is parsed on the calling thread while the others run on worker
+ * threads. A range whose thread cannot be created is parsed on the calling
+ * thread.
+ *
+ * @param chunks Row ranges from `split_chunks()`.
+ * @param n Number of row ranges.
+ * @param ctx Rendering context with vectors sized for the whole map.
+ * @return `true` if every row was parsed with the same number of columns.
+ */
+bool	run_chunks(t_chunk *chunks, int n, t_context *ctx)
+{
+	bool	ok;
+	int		k;
+
+	k = -1;
+	while (++k < n)
+	{
+		chunks[k].ctx = ctx;
+		chunks[k].alt = vec2i(INT_MAX, INT_MIN);
+		chunks[k].joinable = k > 0 && pthread_create(
+				&chunks[k].thread, NULL, parse_chunk, &chunks[k]) == 0;
+	}
+	parse_chunk(&chunks[0]);
+	ok = chunks[0].ok;
+	k = 0;
+	while (++k < n)
+	{
+		if (chunks[k].joinable)
+			pthread_join(chunks[k].thread, NULL);
+		else
+			parse_chunk(&chunks[k]);
+		ok = ok && chunks[k].ok;
+	}
+	return (ok);
+}
+
+/**
+ * Thread routine that parses the rows of a single range. Each row is
+ * published so the renderer can draw it while the rest is still parsed.
+ *
+ * Stops early when the loader is cancelled.
+ *
+ * @param param Row range.
+ * @return NULL.
+ */
+static void	*parse_chunk(void *param)
+{
+	t_chunk	*chunk;
+	int		row;
+
+	chunk = param;
+	chunk->ok = true;
+	scan_init(&chunk->scan, chunk->cur.ptr, chunk->cur.end);
+	row = chunk->row;
+	while (chunk->ok && row < chunk->row + chunk->rows)
+	{
+		chunk->ok = !atomic_load(&chunk->ctx->load.cancel) &&
+			parse_line(chunk, row) == chunk->ctx->rows_cols.y;
+		if (chunk->ok)
+			publish_row(chunk->ctx, row, chunk->alt);
+		++row;
+	}
+	return (NULL);
+}
+
+/**
+ * Decides how many threads parse a file of the given size.
+ *
+ * @param size File size in bytes.
+ * @return Number of online processors, capped at THREADS_MAX,
+ * or 1 for files smaller than PARSE_MT_SIZE.
+ */
+static inline int	thread_count(size_t size)
+{
+	long	n;
+
+	if (size < PARSE_MT_SIZE)
+		return (1);
+	n = sysconf(_SC_NPROCESSORS_ONLN);
+	if (n < 1)
+		return (1);
+	if (n > THREADS_MAX)
+		return (THREADS_MAX);
+	return (n);
+}
+
+/**
+ * Returns the start of the line following the one at `ptr`.
+ *
+ * @param ptr Start of the current line.
+ * @param end End of the mapped file.
+ * @return Start of the next line, or `end` if this is the last line.
+ */
+static inline const char	*next_line(const char *ptr, const char *end)
+{
+	ptr = ft_memchr(ptr, '\n', end - ptr);
+	if (!ptr)
+		return (end);
+	return (ptr + 1);
+}
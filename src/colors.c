@@ -6,7 +6,7 @@
 /*   By: myli-pen <myli-pen@student.hive.fi>        +#+  +:+       +#+        */
 /*                                                +#+#+#+#+#+   +#+           */
 /*   Created: 2025/07/16 23:09:05 by myli-pen          #+#    #+#             */
-/*   Updated: 2025/08/06 20:41:55 by myli-pen         ###   ########.fr       */
+/*   Updated: 2026/10/18 02:37:23 by myli-pen         ###   ########.fr       */
 /*                                                                            */
 /* ************************************************************************** */
 
@@ -15,6 +15,7 @@
 /**
  * Clears the render image pixels with a solid color and the Z-buffer to INF.
  * Sets the data for the first row, then copies it to the subsequent rows.
+ * The hierarchical Z-buffer is cleared along (see `clear_hiz()`).
  *
  * @param ctx Model context containing render image and Z-buffer.
  * @param color Color (32-bit RGBA).
@@ -43,6 +44,7 @@ void	clear_image(t_context *ctx, uint32_t color)
 		ft_memcpy(&ctx->z_buf[i * width], ctx->z_buf, width * sizeof(float));
 		++i;
 	}
+	clear_hiz(ctx);
 }
 
 /**
@@ -94,3 +96,15 @@ uint32_t	rainbow_rgb(double t)
 	b = (sin(t + 4.0f) * 0.5f + 0.5f) * 255.0f;
 	return ((uint8_t)r << 24 | (uint8_t)g << 16 | (uint8_t)b << 8 | 0xFF);
 }
+
+/**
+ * Reverses the channels of a color into the byte order of the framebuffer.
+ *
+ * @param c Color (32-bit RGBA).
+ * @return Color (32-bit ABGR).
+ */
+uint32_t	abgr_color(uint32_t c)
+{
+	return ((c & 0xFF) << 24 | (c & 0xFF00) << 8 |
+		(c & 0xFF0000) >> 8 | (c & 0xFF000000) >> 24);
+}
@@ -6,48 +6,67 @@
 /*   By: myli-pen <myli-pen@student.hive.fi>        +#+  +:+       +#+        */
 /*                                                +#+#+#+#+#+   +#+           */
 /*   Created: 2025/07/25 15:08:22 by myli-pen          #+#    #+#             */
-/*   Updated: 2025/07/29 12:51:22 by myli-pen         ###   ########.fr       */
+/*   Updated: 2026/10/18 01:14:31 by myli-pen         ###   ########.fr       */
 /*                                                                            */
 /* ************************************************************************** */
 
 #include "fdf.h"
 
+static inline float	alt_weight(t_context *ctx, float alt);
+
 /**
- * Performs a depth test for a pixel and updates the z-buffer if visible.
- *
- * Interpolates the depth of the current pixel along the line
- * segment between `v0` and `v1`, using the interpolation parameter `t.x`.
- * The computed depth is compared against the z-buffer at the (x, y)
- * screen coordinates.
+ * Sets up the fixed-point values `draw_segment()` steps along a segment, so
+ * that no pixel needs a divide nor a lerp: the depth, with 32 fractional
+ * bits, and the weight of `color1` against `color0`, with FIX_COLOR ones.
  *
- * If the pixel is closer than the current value in the z-buffer,
- * the function updates the z-buffer and sets the color to be drawn.
+ * In AMAZING mode the colors are the ones of the context, and the weight is
+ * the normalized altitude. It is linear along the segment, and clamped per
+ * pixel like `ft_normalize()` does.
  *
- * @param ctx   Rendering context containing the z-buffer and color settings.
- * @param v0    Starting vertex of the segment.
- * @param v1    Ending vertex of the segment.
- * @param t     Interpolation parameters.
- * @return      True if the pixel passes the depth test and should be drawn.
+ * @param ctx Rendering context containing color settings and altitude range.
+ * @param seg Segment in screen space, out steps.
+ * @param v0 Vertex 0 in screen space.
+ * @param v1 Vertex 1 in screen space.
  */
-bool	depth_test(t_context *ctx, t_vertex v0, t_vertex v1, t_vec3 t)
+void	segment_steps(t_context *ctx, t_segment *seg, t_vertex *v0,
+			t_vertex *v1)
 {
-	float	depth;
-	int		index;
+	double	n;
+	t_vec2	t;
 
-	depth = ft_lerp(v0.depth, v1.depth, t.x);
-	index = v0.s.y * ctx->img->width + v0.s.x;
-	if (depth < ctx->z_buf[index])
+	n = ft_imax(abs(seg->s1.x - seg->s0.x), abs(seg->s1.y - seg->s0.y));
+	seg->depth = (int64_t)(v0->depth * FIX_DEPTH_ONE);
+	seg->ddepth = (int64_t)(((double)v1->depth - v0->depth) * FIX_DEPTH_ONE
+			/ n);
+	t = vec2(0.0f, 1.0f);
+	seg->color0 = abgr_color(v0->color);
+	seg->color1 = abgr_color(v1->color);
+	if (ctx->color_mode == AMAZING)
 	{
-		ctx->z_buf[index] = depth;
-		if (ctx->color_mode == AMAZING)
-		{
-			t.y = ft_lerp(v0.o_pos.y, v1.o_pos.y, t.x);
-			t.z = ft_normalize(t.y, ctx->alt_min_max.x, ctx->alt_min_max.y);
-			ctx->color = lerp_color(ctx->color1, ctx->color2, t.z);
-		}
-		else
-			ctx->color = lerp_color(v0.color, v1.color, t.x);
-		return (true);
+		t = vec2(alt_weight(ctx, v0->o_pos.z), alt_weight(ctx, v1->o_pos.z));
+		seg->color0 = abgr_color(ctx->color1);
+		seg->color1 = abgr_color(ctx->color2);
 	}
-	return (false);
+	seg->t = (int32_t)(t.x * (1 << FIX_COLOR));
+	seg->dt = (int32_t)((t.y - t.x) * (1 << FIX_COLOR) / n);
+}
+
+/**
+ * Normalizes an altitude into the altitude range of the map, without
+ * clamping it, so it stays linear along a segment. Bounded to keep its
+ * fixed-point steps in range.
+ *
+ * @param ctx Rendering context containing the altitude range.
+ * @param alt Altitude in object space.
+ * @return Weight of `color2`, 0 to 1 within the altitude range.
+ */
+static inline float	alt_weight(t_context *ctx, float alt)
+{
+	float	range;
+
+	range = ctx->alt_min_max.y - ctx->alt_min_max.x;
+	if (range <= 0.0f)
+		return (0.0f);
+	alt = (alt - ctx->o_center.z - ctx->alt_min_max.x) / range;
+	return (fminf(fmaxf(alt, -16.0f), 16.0f));
 }
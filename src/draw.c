@@ -0,0 +1,185 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   draw.c                                             :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: myli-pen <myli-pen@student.hive.fi>        +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/18 00:43:20 by myli-pen          #+#    #+#             */
+/*   Updated: 2026/10/18 02:52:09 by myli-pen         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "fdf.h"
+
+static inline void	init_line(t_context *ctx, t_segment *seg, t_line *l);
+static inline void	move_pixel(t_line *l);
+
+/**
+ * Implements Bresenham's line algorithm with incremental error tracking
+ * as best approximation to the ideal line.
+ * Interpolates both color and depth (z) along the line, stepping the
+ * fixed-point values set up by `segment_steps()` with every pixel.
+ *
+ * Lines at least RUN_RATIO times longer along their major axis than along
+ * the other are made of long runs of pixels, and are drawn run by run
+ * instead, with the same pixels (see `draw_runs()`).
+ *
+ * The tile of the hierarchical Z-buffer where the segment starts is marked
+ * first, for `refresh_hiz()` (see `mark_segment()`).
+ *
+ * Only the pixels in the band of rows `band.x` to `band.y` (excluded) are
+ * drawn: the walk starts at the first pixel of the segment in the band (see
+ * `seek_band()`), and stops once it has left the band. Each pixel gets the
+ * same depth and color it would get if the segment was drawn whole.
+ *
+ * @param ctx Rendering context containing render image and Z-buffer.
+ * @param seg Segment in screen space, clipped to the image.
+ * @param band First and past the last row to draw.
+ */
+void	draw_segment(t_context *ctx, t_segment *seg, t_vec2i band)
+{
+	t_line	l;
+
+	init_line(ctx, seg, &l);
+	mark_segment(ctx, seg, l.n + 1, band);
+	seek_band(&l, band);
+	if (l.d.x >= RUN_RATIO * l.d.y || l.d.y >= RUN_RATIO * l.d.x)
+	{
+		draw_runs(ctx, seg, &l, band);
+		return ;
+	}
+	while (l.i <= l.n && (l.s.y < 0 || l.p.y < band.y) &&
+		(l.s.y > 0 || l.p.y >= band.x))
+	{
+		if (l.p.y >= band.x && l.p.y < band.y)
+			draw_pixel(ctx, seg, &l.px);
+		++l.i;
+		l.px.depth += l.px.ddepth;
+		l.px.t += l.px.dt;
+		move_pixel(&l);
+	}
+}
+
+/**
+ * Starts the walk of a segment at its first pixel.
+ *
+ * @param ctx Rendering context containing render image.
+ * @param seg Segment in screen space.
+ * @param l Out line walk.
+ */
+static inline void	init_line(t_context *ctx, t_segment *seg, t_line *l)
+{
+	l->d = vec2i(abs(seg->s1.x - seg->s0.x), abs(seg->s1.y - seg->s0.y));
+	l->s = vec2i(1 + (-2 * (seg->s0.x >= seg->s1.x)),
+			1 + (-2 * (seg->s0.y >= seg->s1.y)));
+	l->p = seg->s0;
+	l->error = l->d.x - l->d.y;
+	l->i = 0;
+	l->n = ft_imax(l->d.x, l->d.y);
+	l->stride = l->s.y * (int)ctx->img->width;
+	l->px.index = l->p.y * ctx->img->width + l->p.x;
+	l->px.depth = seg->depth;
+	l->px.ddepth = seg->ddepth;
+	l->px.t = seg->t;
+	l->px.dt = seg->dt;
+}
+
+/**
+ * Advances the current pixel position along the line.
+ * Uses the accumulated error term to determine a step in
+ * x, y, or both directions.
+ *
+ * @param l Line walk, its pixel and error term updated in-place.
+ */
+static inline void	move_pixel(t_line *l)
+{
+	int	e2;
+
+	e2 = 2 * l->error;
+	if (e2 > -l->d.y)
+	{
+		l->error -= l->d.y;
+		l->p.x += l->s.x;
+		l->px.index += l->s.x;
+	}
+	if (e2 < l->d.x)
+	{
+		l->error += l->d.x;
+		l->p.y += l->s.y;
+		l->px.index += l->stride;
+	}
+}
+
+/**
+ * Draws a vertical run of `l->px.n` pixels of a line from its current
+ * pixel, in the direction of the line, skipping the pixels outside the
+ * band of rows.
+ *
+ * @param ctx Rendering context containing render image and Z-buffer.
+ * @param seg Segment in screen space.
+ * @param l Line walk at the first pixel of the run.
+ * @param band First and past the last row to draw.
+ */
+void	draw_column(t_context *ctx, t_segment *seg, t_line *l, t_vec2i band)
+{
+	t_span	px;
+	t_vec2i	edge;
+	int		end;
+	int		k;
+
+	px = l->px;
+	edge = band;
+	if (l->s.y < 0)
+		edge = vec2i(band.y - 1, band.x - 1);
+	k = ft_imax(0, (edge.x - l->p.y) * l->s.y);
+	end = ft_imin(px.n, (edge.y - l->p.y) * l->s.y);
+	px.index += k * l->stride;
+	px.depth += k * px.ddepth;
+	px.t += k * px.dt;
+	while (k++ < end)
+	{
+		draw_pixel(ctx, seg, &px);
+		px.index += l->stride;
+		px.depth += px.ddepth;
+		px.t += px.dt;
+	}
+}
+
+/**
+ * Draws a pixel if it passes the depth test against the pixel previously
+ * drawn at the same location, updating the Z-buffer.
+ * The color is blended from the two colors of the segment by the clamped
+ * weight of the walk, two channels at a time, in the 32-bit ABGR order of
+ * the framebuffer. Segments are clipped to the image, so every pixel is
+ * inside of it.
+ *
+ * Only called by the worker owning the band of the pixel, so the Z-buffer
+ * needs no lock.
+ *
+ * @param ctx Rendering context containing render image and Z-buffer.
+ * @param seg Segment in screen space.
+ * @param px Pixel index, depth and weight.
+ */
+void	draw_pixel(t_context *ctx, t_segment *seg, t_span *px)
+{
+	float		depth;
+	uint32_t	w;
+	uint32_t	rb;
+	uint32_t	ag;
+
+	depth = px->depth * (float)(1.0 / FIX_DEPTH_ONE);
+	if (depth >= ctx->z_buf[px->index])
+		return ;
+	ctx->z_buf[px->index] = depth;
+	w = 0;
+	if (px->t > 0)
+		w = (uint32_t)px->t >> (FIX_COLOR - 8);
+	if (w > 256)
+		w = 256;
+	rb = (seg->color0 & 0xFF00FF) * (256 - w) + (seg->color1 & 0xFF00FF) * w;
+	ag = (seg->color0 >> 8 & 0xFF00FF) * (256 - w) +
+		(seg->color1 >> 8 & 0xFF00FF) * w;
+	((uint32_t *)ctx->img->pixels)[px->index] = (rb >> 8 & 0xFF00FF) |
+		(ag & 0xFF00FF00);
+}
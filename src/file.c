@@ -0,0 +1,140 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   file.c                                             :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: myli-pen <myli-pen@student.hive.fi>        +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/17 22:26:26 by myli-pen          #+#    #+#             */
+/*   Updated: 2026/10/18 04:02:35 by myli-pen         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "fdf.h"
+
+static inline bool	regular_file(int fd, struct stat *st);
+
+/**
+ * Maps a file read-only into memory so it can be tokenized in place.
+ *
+ * The pages are hinted for sequential access, letting the kernel read ahead
+ * while the parser walks the mapping from start to end.
+ *
+ * Empty files, directories and anything that cannot be mapped are rejected,
+ * with `errno` set.
+ *
+ * @param path Path to the file.
+ * @param file Out mapping with the data pointer and size in bytes.
+ * @return `true` on success, `false` on failure.
+ */
+bool	map_file(char *path, t_file *file)
+{
+	struct stat	st;
+	int			fd;
+
+	file->data = NULL;
+	file->size = 0;
+	fd = open(path, O_RDONLY);
+	if (fd == ERROR)
+		return (false);
+	if (!regular_file(fd, &st))
+		return (close(fd), false);
+	file->data = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd);
+	if (file->data == MAP_FAILED)
+	{
+		file->data = NULL;
+		return (false);
+	}
+	file->size = st.st_size;
+	madvise(file->data, file->size, MADV_SEQUENTIAL);
+	return (true);
+}
+
+/**
+ * Releases a mapping created by `map_file()`.
+ *
+ * @param file Mapping to release.
+ */
+void	unmap_file(t_file *file)
+{
+	if (file->data)
+		munmap(file->data, file->size);
+	file->data = NULL;
+	file->size = 0;
+}
+
+/**
+ * Creates a new file of the given size with a unique name, and maps it
+ * writable and shared, so the stores into the mapping end up in the file.
+ *
+ * @param path Template of the path of the file to create, whose trailing
+ * XXXXXX are replaced with the unique name (see mkstemp(3)).
+ * @param size Size of the file in bytes.
+ * @param file Out mapping with the data pointer and size in bytes.
+ * @return `true` on success, `false` on failure.
+ */
+bool	create_file(char *path, size_t size, t_file *file)
+{
+	int	fd;
+
+	file->data = NULL;
+	file->size = 0;
+	fd = mkstemp(path);
+	if (fd == ERROR)
+		return (false);
+	if (fchmod(fd, 0644) == ERROR || ftruncate(fd, size) == ERROR)
+		return (close(fd), unlink(path), false);
+	file->data = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	close(fd);
+	if (file->data == MAP_FAILED)
+	{
+		file->data = NULL;
+		unlink(path);
+		return (false);
+	}
+	file->size = size;
+	return (true);
+}
+
+/**
+ * Releases the resident pages of a file mapping. The contents stay in the
+ * file, and are paged in again from it on the next access.
+ * Only the pages that lie entirely inside the range are released.
+ *
+ * @param ptr Start of the range.
+ * @param size Size of the range in bytes.
+ */
+void	drop_pages(void *ptr, size_t size)
+{
+	uintptr_t	start;
+	uintptr_t	end;
+	uintptr_t	page;
+
+	page = sysconf(_SC_PAGESIZE);
+	start = ((uintptr_t)ptr + page - 1) & ~(page - 1);
+	end = ((uintptr_t)ptr + size) & ~(page - 1);
+	if (start < end)
+		madvise((void *)start, end - start, MADV_DONTNEED);
+}
+
+/**
+ * Checks that an open file is a regular file with contents, setting `errno`
+ * to EISDIR for directories and EINVAL for anything else rejected.
+ *
+ * @param fd Open file.
+ * @param st Out status of the file.
+ * @return `true` if the file can be mapped.
+ */
+static inline bool	regular_file(int fd, struct stat *st)
+{
+	if (fstat(fd, st) == ERROR)
+		return (false);
+	if (S_ISDIR(st->st_mode))
+		errno = EISDIR;
+	else if (!S_ISREG(st->st_mode) || st->st_size <= 0)
+		errno = EINVAL;
+	else
+		return (true);
+	return (false);
+}
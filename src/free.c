@@ -0,0 +1,48 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   free.c                                             :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: myli-pen <myli-pen@student.hive.fi>        +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/17 23:26:43 by myli-pen          #+#    #+#             */
+/*   Updated: 2026/10/18 01:01:00 by myli-pen         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "fdf.h"
+
+/**
+ * Logs errors on stderr and terminates mlx before exiting.
+ *
+ * @param mlx Mlx context.
+ * @param message Error message.
+ */
+void	ft_error(mlx_t *mlx, char *message, t_context *ctx)
+{
+	ft_putstr_fd("FdF:\tError: ", STDERR_FILENO);
+	ft_putendl_fd(message, STDERR_FILENO);
+	if (mlx)
+	{
+		ft_putstr_fd("MLX42:\t", STDERR_FILENO);
+		perror(mlx_strerror(mlx_errno));
+		mlx_terminate(mlx);
+	}
+	free(ctx);
+	exit(EXIT_FAILURE);
+}
+
+/**
+ * Frees the rendering context, Z-buffer, post-transform buffer and the vertex
+ * store.
+ *
+ * @param ctx Rendering context.
+ */
+void	fdf_free(t_context *ctx)
+{
+	stop_loader(ctx);
+	verts_free(&ctx->verts);
+	ft_arena_free(&ctx->frame);
+	free_workers(ctx);
+	free(ctx->z_buf);
+}
@@ -0,0 +1,105 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   hiz.c                                              :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: myli-pen <myli-pen@student.hive.fi>        +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/18 01:33:48 by myli-pen          #+#    #+#             */
+/*   Updated: 2026/10/18 02:37:23 by myli-pen         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "fdf.h"
+
+static inline float	tile_max(t_context *ctx, t_vec2i tile);
+
+/**
+ * Clears the farthest depth of every tile of the hierarchical Z-buffer to
+ * INF, like the Z-buffer, with no pixel of any tile drawn yet.
+ *
+ * @param ctx Rendering context containing the hierarchical Z-buffer.
+ */
+void	clear_hiz(t_context *ctx)
+{
+	int	i;
+
+	i = -1;
+	while (++i < ctx->hz.size.x * ctx->hz.size.y)
+		ctx->hz.max[i] = INFINITY;
+	ft_bzero(ctx->hz.drawn,
+		(sizeof(uint16_t) + 1) * ctx->hz.size.x * ctx->hz.size.y);
+}
+
+/**
+ * Brings the hierarchical Z-buffer of a band of rows up to date: every tile
+ * of HZ_SIZE by HZ_SIZE pixels drawn since the last refresh gets the
+ * farthest depth of its pixels again. Tiles not drawn keep theirs, and so
+ * do tiles with fewer pixels drawn than they have, as some of their pixels
+ * must still be INF: in a wireframe, most of them. A tile found with a
+ * pixel still INF starts counting again, so it is not scanned at every
+ * batch that draws in it.
+ *
+ * The depth of a tile only ever goes down between two refreshes, so the
+ * depth it holds is never nearer than any of its pixels, even when stale.
+ * Bands are cut at multiples of HZ_SIZE rows, so every tile belongs to the
+ * worker of a single band, and needs no lock.
+ *
+ * @param ctx Rendering context containing the Z-buffer.
+ * @param rows First and past the last row of the band.
+ */
+void	refresh_hiz(t_context *ctx, t_vec2i rows)
+{
+	t_vec2i	tile;
+	int		end;
+	int		i;
+
+	tile.y = rows.x >> HZ_SHIFT;
+	end = (ft_imin(rows.y, ctx->img->height) + HZ_SIZE - 1) >> HZ_SHIFT;
+	while (tile.y < end)
+	{
+		tile.x = -1;
+		while (++tile.x < ctx->hz.size.x)
+		{
+			i = tile.y * ctx->hz.size.x + tile.x;
+			if (ctx->hz.dirty[i] && ctx->hz.drawn[i] >= HZ_SIZE * HZ_SIZE)
+				ctx->hz.max[i] = tile_max(ctx, tile);
+			if (ctx->hz.max[i] == INFINITY
+				&& ctx->hz.drawn[i] >= HZ_SIZE * HZ_SIZE)
+				ctx->hz.drawn[i] = 0;
+			ctx->hz.dirty[i] = 0;
+		}
+		++tile.y;
+	}
+}
+
+/**
+ * Finds the farthest depth of the pixels of a tile, the tiles on the right
+ * and bottom edges of the image being cut to it. Stops at the first pixel
+ * not drawn yet, as nothing can be rejected in the tile then.
+ *
+ * @param ctx Rendering context containing the Z-buffer.
+ * @param tile Column (x) and row (y) of the tile.
+ * @return Farthest depth of the tile.
+ */
+static inline float	tile_max(t_context *ctx, t_vec2i tile)
+{
+	t_vec2i	p;
+	t_vec2i	end;
+	float	max;
+
+	end = vec2i(ft_imin((tile.x + 1) << HZ_SHIFT, ctx->img->width),
+			ft_imin((tile.y + 1) << HZ_SHIFT, ctx->img->height));
+	max = -INFINITY;
+	p.y = (tile.y << HZ_SHIFT) - 1;
+	while (++p.y < end.y && max < INFINITY)
+	{
+		p.x = (tile.x << HZ_SHIFT) - 1;
+		while (++p.x < end.x)
+		{
+			if (ctx->z_buf[p.y * ctx->img->width + p.x] > max)
+				max = ctx->z_buf[p.y * ctx->img->width + p.x];
+		}
+	}
+	return (max);
+}
@@ -0,0 +1,173 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   hiz_reject.c                                       :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: myli-pen <myli-pen@student.hive.fi>        +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/18 02:08:10 by myli-pen          #+#    #+#             */
+/*   Updated: 2026/10/18 02:44:35 by myli-pen         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "fdf.h"
+
+static inline bool	hiz_hidden(t_context *ctx, t_vec2i lo, t_vec2i hi,
+						t_span *sp);
+static inline void	mark_tiles(t_context *ctx, t_vec2i lo, t_vec2i hi, int n);
+
+/**
+ * Tests pixels against the hierarchical Z-buffer, before any of them is
+ * walked. They are hidden if their nearest depth, at one of the ends of
+ * their run, is not nearer than the farthest depth of every tile of their
+ * box, as each of them would then fail `draw_pixel()`.
+ *
+ * @param ctx Rendering context containing the hierarchical Z-buffer.
+ * @param lo Top left pixel of the box.
+ * @param hi Bottom right pixel of the box.
+ * @param sp Depth of the first pixel, its step, and number of pixels.
+ * @return `true` if every pixel is hidden.
+ */
+static inline bool	hiz_hidden(t_context *ctx, t_vec2i lo, t_vec2i hi,
+						t_span *sp)
+{
+	t_vec2i	p;
+	int64_t	near;
+	float	depth;
+
+	near = sp->depth + (sp->n - 1) * sp->ddepth;
+	if (sp->depth < near)
+		near = sp->depth;
+	depth = near * (float)(1.0 / FIX_DEPTH_ONE);
+	p.y = (lo.y >> HZ_SHIFT) - 1;
+	while (++p.y <= hi.y >> HZ_SHIFT)
+	{
+		p.x = (lo.x >> HZ_SHIFT) - 1;
+		while (++p.x <= hi.x >> HZ_SHIFT)
+		{
+			if (depth < ctx->hz.max[p.y * ctx->hz.size.x + p.x])
+				return (false);
+		}
+	}
+	return (true);
+}
+
+/**
+ * Marks the tiles of the box from `lo` to `hi` as drawn since the last
+ * refresh (see `refresh_hiz()`), and counts the pixels drawn in each of
+ * them, up to the pixels of a tile. The count is never lower than the
+ * pixels actually drawn, as every tile is counted all of the `n` pixels of
+ * the box.
+ *
+ * @param ctx Rendering context containing the hierarchical Z-buffer.
+ * @param lo Top left pixel of the box, inside the band of the worker.
+ * @param hi Bottom right pixel of the box, inside the band of the worker.
+ * @param n Number of pixels in the box.
+ */
+static inline void	mark_tiles(t_context *ctx, t_vec2i lo, t_vec2i hi, int n)
+{
+	t_vec2i	p;
+	int		i;
+
+	p.y = (lo.y >> HZ_SHIFT) - 1;
+	while (++p.y <= hi.y >> HZ_SHIFT)
+	{
+		p.x = (lo.x >> HZ_SHIFT) - 1;
+		while (++p.x <= hi.x >> HZ_SHIFT)
+		{
+			i = p.y * ctx->hz.size.x + p.x;
+			ctx->hz.dirty[i] = 1;
+			if (ctx->hz.drawn[i] < HZ_SIZE * HZ_SIZE)
+				ctx->hz.drawn[i] += n;
+		}
+	}
+}
+
+/**
+ * Tests a whole segment against the hierarchical Z-buffer, as it is
+ * emitted. The bands are not drawn while segments are emitted, so the
+ * Z-buffer holds still. The tile of the first pixel is looked at first, as
+ * most tiles of a wireframe are never full. Segments spanning more than
+ * HZ_TEST_MAX tiles are not tested as a whole, only their horizontal runs
+ * are (see `draw_runs()`).
+ *
+ * @param ctx Rendering context containing the hierarchical Z-buffer.
+ * @param seg Segment in screen space, with its steps.
+ * @return `true` if every pixel of the segment is hidden.
+ */
+bool	segment_hidden(t_context *ctx, t_segment *seg)
+{
+	t_vec2i	lo;
+	t_vec2i	hi;
+	t_span	sp;
+
+	if (ctx->hz.max[(seg->s0.y >> HZ_SHIFT) * ctx->hz.size.x
+			+ (seg->s0.x >> HZ_SHIFT)] == INFINITY)
+		return (false);
+	lo = seg->s0;
+	hi = seg->s1;
+	if (seg->s1.x < seg->s0.x)
+		lo.x = seg->s1.x;
+	if (seg->s1.x < seg->s0.x)
+		hi.x = seg->s0.x;
+	if (seg->s1.y < seg->s0.y)
+		lo.y = seg->s1.y;
+	if (seg->s1.y < seg->s0.y)
+		hi.y = seg->s0.y;
+	if (((hi.x >> HZ_SHIFT) - (lo.x >> HZ_SHIFT) + 1) *
+		((hi.y >> HZ_SHIFT) - (lo.y >> HZ_SHIFT) + 1) > HZ_TEST_MAX)
+		return (false);
+	sp.depth = seg->depth;
+	sp.ddepth = seg->ddepth;
+	sp.n = ft_imax(hi.x - lo.x, hi.y - lo.y) + 1;
+	return (hiz_hidden(ctx, lo, hi, &sp));
+}
+
+/**
+ * Marks the tile of the first pixel of a segment, when it lies in the band,
+ * as drawn since the last refresh, and counts the pixels of the segment in
+ * it, up to the HZ_SIZE a line can have in a tile. Segments of a grid
+ * start in every tile they cover, so this is enough to find the tiles worth
+ * refreshing, for a store per segment. The tiles missed only stay farther
+ * than they could be until drawn again.
+ *
+ * @param ctx Rendering context containing the hierarchical Z-buffer.
+ * @param seg Segment in screen space.
+ * @param n Number of pixels of the segment.
+ * @param band First and past the last row drawn.
+ */
+void	mark_segment(t_context *ctx, t_segment *seg, int n, t_vec2i band)
+{
+	int	i;
+
+	if (seg->s0.y < band.x || seg->s0.y >= band.y)
+		return ;
+	i = (seg->s0.y >> HZ_SHIFT) * ctx->hz.size.x + (seg->s0.x >> HZ_SHIFT);
+	ctx->hz.dirty[i] = 1;
+	if (ctx->hz.drawn[i] < HZ_SIZE * HZ_SIZE)
+		ctx->hz.drawn[i] += ft_imin(n, HZ_SIZE);
+}
+
+/**
+ * Tests a horizontal run of pixels of a segment against the hierarchical
+ * Z-buffer, and marks its tiles if it is not hidden. Runs narrower than a
+ * tile were tested with their segment (see `segment_hidden()`), and are
+ * not tested again.
+ *
+ * @param ctx Rendering context containing the hierarchical Z-buffer.
+ * @param lo Leftmost pixel of the run, inside the band of the worker.
+ * @param sp Depth of the first pixel, its step, and number of pixels.
+ * @return `true` if some pixel may be drawn.
+ */
+bool	span_visible(t_context *ctx, t_vec2i lo, t_span *sp)
+{
+	t_vec2i	hi;
+
+	if (sp->n < HZ_SIZE)
+		return (true);
+	hi = vec2i(lo.x + sp->n - 1, lo.y);
+	if (hiz_hidden(ctx, lo, hi, sp))
+		return (false);
+	mark_tiles(ctx, lo, hi, sp->n);
+	return (true);
+}
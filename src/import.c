@@ -0,0 +1,115 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   import.c                                           :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: myli-pen <myli-pen@student.hive.fi>        +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/17 23:23:59 by myli-pen          #+#    #+#             */
+/*   Updated: 2026/10/17 23:53:29 by myli-pen         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "fdf.h"
+
+static inline bool	import_row(t_context *ctx, t_raster *raster, int row,
+						t_vec2i *alt);
+static inline int	sample(t_raster *raster, size_t i);
+
+/**
+ * Imports a binary heightmap into the vertex vector, decoding the samples
+ * straight from the mapped file without producing any text. Runs on the
+ * loader thread, and publishes every completed row like the parser does.
+ *
+ * The samples are the heights, every vertex is WHITE.
+ *
+ * @param ctx Rendering context containing the mapped file and the vectors.
+ * @return `true` on success, `false` on failure.
+ */
+bool	import_map(t_context *ctx)
+{
+	t_raster	raster;
+	t_vec2i		alt;
+	int			row;
+
+	if (!raster_init(ctx, &raster))
+		return (false);
+	ctx->rows_cols = raster.rows_cols;
+	if (!alloc_rows(ctx))
+		return (false);
+	alt = vec2i(INT_MAX, INT_MIN);
+	row = -1;
+	while (++row < ctx->rows_cols.x)
+	{
+		if (atomic_load(&ctx->load.cancel) ||
+			!import_row(ctx, &raster, row, &alt))
+			return (false);
+		publish_row(ctx, row, alt);
+	}
+	return (true);
+}
+
+/**
+ * Creates the vertices of one row. Extends the altitude range of the rows
+ * imported so far.
+ *
+ * @param ctx Rendering context.
+ * @param raster Samples of the heightmap.
+ * @param row Row index.
+ * @param alt Altitude range to extend.
+ * @return `true` on success, `false` on allocation failure.
+ */
+static inline bool	import_row(t_context *ctx, t_raster *raster, int row,
+						t_vec2i *alt)
+{
+	t_vec2i	pos;
+	int		z;
+
+	pos = vec2i(-1, row);
+	while (++pos.x < raster->rows_cols.y)
+	{
+		z = sample(raster, (size_t)row * raster->rows_cols.y + pos.x);
+		alt->x = ft_imin(alt->x, z);
+		alt->y = ft_imax(alt->y, z);
+		if (!make_vert(ctx, pos, z, WHITE))
+			return (false);
+	}
+	return (true);
+}
+
+/**
+ * Decodes a sample into a height.
+ *
+ * SRTM voids (-32768) become 0. Floating point samples are rounded and
+ * clamped to the range of exactly representable integers, NaN becomes 0.
+ *
+ * @param raster Samples of the heightmap.
+ * @param i Index of the sample.
+ * @return Height.
+ */
+static inline int	sample(t_raster *raster, size_t i)
+{
+	const uint8_t	*p;
+	int16_t			s;
+	float			f;
+
+	if (raster->sample == SAMPLE_U8)
+		return (raster->data[i]);
+	p = raster->data + i * 2;
+	if (raster->sample == SAMPLE_U16_BE)
+		return (p[0] << 8 | p[1]);
+	s = (int16_t)(p[0] << 8 | p[1]);
+	if (raster->sample == SAMPLE_I16_BE)
+		return (s * (s != INT16_MIN));
+	if (raster->sample == SAMPLE_F32)
+	{
+		ft_memcpy(&f, raster->data + i * 4, sizeof(float));
+		if (f != f)
+			return (0);
+		return (lroundf(ft_clamp(f, -16777216.0f, 16777216.0f)));
+	}
+	ft_memcpy(&s, p, sizeof(int16_t));
+	if (raster->sample == SAMPLE_U16)
+		return ((uint16_t)s);
+	return (s);
+}
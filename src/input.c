@@ -6,7 +6,7 @@
 /*   By: myli-pen <myli-pen@student.hive.fi>        +#+  +:+       +#+        */
 /*                                                +#+#+#+#+#+   +#+           */
 /*   Created: 2025/07/23 23:56:47 by myli-pen          #+#    #+#             */
-/*   Updated: 2025/07/31 01:51:18 by myli-pen         ###   ########.fr       */
+/*   Updated: 2026/10/18 00:39:43 by myli-pen         ###   ########.fr       */
 /*                                                                            */
 /* ************************************************************************** */
 
@@ -112,6 +112,8 @@ void	translate_rotate(t_context *ctx)
  *
  * - [R]		reset model transform and camera angle.
  *
+ * - [M]		print the memory report (see `memory_report()`).
+ *
  * @param keydata Mlx key data.
  * @param param Rendering context.
  */
@@ -122,14 +124,15 @@ void	key_hook(mlx_key_data_t keydata, void *param)
 	ctx = param;
 	if (keydata.key == MLX_KEY_ESCAPE && keydata.action == MLX_RELEASE)
 		mlx_close_window(ctx->mlx);
+	if (keydata.key == MLX_KEY_M && keydata.action == MLX_RELEASE)
+		memory_report(ctx);
 	if (keydata.key == MLX_KEY_P && keydata.action == MLX_RELEASE)
-	{
 		ctx->cam.projection = (ctx->cam.projection + 1) % 3;
-		if (ctx->cam.projection == ISOMETRIC)
-		{
-			ctx->color_mode = DEFAULT;
-			reset_transforms(ctx);
-		}
+	if (keydata.key == MLX_KEY_P && keydata.action == MLX_RELEASE &&
+		ctx->cam.projection == ISOMETRIC)
+	{
+		ctx->color_mode = DEFAULT;
+		reset_transforms(ctx);
 	}
 	if (ctx->cam.projection == ISOMETRIC)
 		return ;
@@ -0,0 +1,170 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   loader.c                                           :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: myli-pen <myli-pen@student.hive.fi>        +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/17 22:34:25 by myli-pen          #+#    #+#             */
+/*   Updated: 2026/10/18 03:57:54 by myli-pen         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "fdf.h"
+
+static void	*load_thread(void *param);
+
+/**
+ * Starts loading the opened map on a background thread, so the window can
+ * show the model while it is still being parsed.
+ *
+ * @param ctx Rendering context with the map opened by `open_map()`.
+ * @return `true` if the loader thread is running.
+ */
+bool	start_loader(t_context *ctx)
+{
+	atomic_init(&ctx->load.state, LOAD_SCANNING);
+	atomic_init(&ctx->load.cancel, false);
+	ctx->load.ready = NULL;
+	ctx->load.tmp = NULL;
+	ctx->load.boxed = false;
+	ft_bzero(&ctx->load.cache, sizeof(t_file));
+	ctx->load.alt = vec2i(INT_MAX, INT_MIN);
+	ctx->load.changed = false;
+	ctx->load.visible = false;
+	ctx->load.finished = false;
+	ctx->load.running = false;
+	ctx->load.rows = 0;
+	ctx->load.cap = 0;
+	ctx->load.grow = 0;
+	if (pthread_mutex_init(&ctx->load.lock, NULL) != 0 ||
+		pthread_cond_init(&ctx->load.resized, NULL) != 0)
+		return (false);
+	ctx->load.running = pthread_create(
+			&ctx->load.thread, NULL, load_thread, ctx) == 0;
+	return (ctx->load.running);
+}
+
+/**
+ * Loader thread routine. Reads a streamed map as it arrives, loads the
+ * vertices from the binary cache, or parses the map text or imports the
+ * binary heightmap, then reports the outcome through the load state.
+ * Parsed and imported maps are stored into the tiles of a new cache along
+ * with the mesh, or only into them for maps drawn out of core, and the
+ * cache is completed here.
+ *
+ * @param param Rendering context.
+ * @return NULL.
+ */
+static void	*load_thread(void *param)
+{
+	t_context	*ctx;
+	bool		ok;
+
+	ctx = param;
+	if (ctx->load.stream)
+		ok = stream_map(ctx);
+	else if (ctx->load.from_cache)
+		ok = read_cache(ctx);
+	else if (ctx->opt.format == FDF)
+		ok = parse_map(ctx);
+	else
+		ok = import_map(ctx);
+	ok = ok && !atomic_load(&ctx->load.cancel);
+	if (ctx->tiles.enabled && !ctx->load.from_cache)
+		finish_cache(ctx, &ctx->tiles.map, ok);
+	else if (ctx->load.cache.data)
+		finish_cache(ctx, &ctx->load.cache, ok);
+	unmap_file(&ctx->load.cache);
+	unmap_file(&ctx->load.file);
+	if (ok)
+		atomic_store(&ctx->load.state, LOAD_DONE);
+	else
+		atomic_store(&ctx->load.state, LOAD_FAILED);
+	return (NULL);
+}
+
+/**
+ * Cancels and joins the loader thread if it is still running, and releases
+ * the loading state and the tiles of maps drawn out of core.
+ *
+ * @param ctx Rendering context.
+ */
+void	stop_loader(t_context *ctx)
+{
+	if (ctx->load.running)
+	{
+		pthread_mutex_lock(&ctx->load.lock);
+		atomic_store(&ctx->load.cancel, true);
+		pthread_cond_broadcast(&ctx->load.resized);
+		pthread_mutex_unlock(&ctx->load.lock);
+		pthread_join(ctx->load.thread, NULL);
+		ctx->load.running = false;
+	}
+	unmap_file(&ctx->load.file);
+	unmap_file(&ctx->load.cache);
+	free(ctx->load.ready);
+	ctx->load.ready = NULL;
+	unmap_file(&ctx->tiles.map);
+	free(ctx->tiles.alt);
+	free(ctx->tiles.prev);
+	free(ctx->tiles.next);
+	free(ctx->tiles.flags);
+	ft_bzero(&ctx->tiles, sizeof(t_tiles));
+	if (ctx->load.stream && ctx->load.fd != STDIN_FILENO)
+		close(ctx->load.fd);
+	ctx->load.stream = false;
+	pthread_mutex_destroy(&ctx->load.lock);
+	pthread_cond_destroy(&ctx->load.resized);
+}
+
+/**
+ * Allocates the per-row ready flags and the storage of the model, exactly
+ * once for the dimensions found by the loader. Then lets the renderer start
+ * drawing the rows as they are published.
+ *
+ * A mesh that would exceed the memory budget is not allocated, the map is
+ * drawn out of core from the tiles of its cache instead (see `open_tiles()`).
+ *
+ * @param ctx Rendering context with `rows_cols` set.
+ * @return `true` on success, `false` on too small maps or allocation failure.
+ */
+bool	alloc_rows(t_context *ctx)
+{
+	t_vec2i	rc;
+
+	rc = ctx->rows_cols;
+	if (rc.x < 2 || rc.y < 2)
+		return (false);
+	ctx->load.ready = ft_calloc(rc.x, sizeof(atomic_uchar));
+	if (!ctx->load.ready)
+		return (false);
+	if ((size_t)rc.x * rc.y * VERT_SIZE > ctx->opt.budget && open_tiles(ctx))
+		ctx->tiles.enabled = true;
+	else if (!alloc_mesh(ctx))
+		return (false);
+	else if (!ctx->load.from_cache && !ctx->load.stream)
+		open_cache(ctx);
+	atomic_store(&ctx->load.state, LOAD_PARSING);
+	return (true);
+}
+
+/**
+ * Publishes the vertices of a completed row to the renderer. Extends the
+ * altitude range of the model, which the main loop picks up to update
+ * bounds and framing.
+ *
+ * @param ctx Rendering context.
+ * @param row Index of the completed row.
+ * @param alt Altitude range of the rows parsed so far by the caller.
+ */
+void	publish_row(t_context *ctx, int row, t_vec2i alt)
+{
+	pthread_mutex_lock(&ctx->load.lock);
+	ctx->load.alt.x = ft_imin(ctx->load.alt.x, alt.x);
+	ctx->load.alt.y = ft_imax(ctx->load.alt.y, alt.y);
+	ctx->load.rows = ft_imax(ctx->load.rows, row + 1);
+	ctx->load.changed = true;
+	pthread_mutex_unlock(&ctx->load.lock);
+	atomic_store_explicit(&ctx->load.ready[row], true, memory_order_release);
+}
@@ -6,7 +6,7 @@
 /*   By: myli-pen <myli-pen@student.hive.fi>        +#+  +:+       +#+        */
 /*                                                +#+#+#+#+#+   +#+           */
 /*   Created: 2025/06/30 17:19:35 by myli-pen          #+#    #+#             */
-/*   Updated: 2025/08/09 00:55:09 by myli-pen         ###   ########.fr       */
+/*   Updated: 2026/10/18 04:02:55 by myli-pen         ###   ########.fr       */
 /*                                                                            */
 /* ************************************************************************** */
 
@@ -29,15 +29,16 @@ static inline void	loop(void *param);
  * and begins model initialization.
  *
  * @param argc Arguments count.
- * @param argv File path e.g. "maps/42.fdf"
+ * @param argv Options and file path e.g. "--budget 512 maps/42.fdf"
  */
 int	main(int argc, char *argv[])
 {
 	mlx_t		*mlx;
 	mlx_image_t	*img;
 	t_context	*ctx;
+	t_options	opt;
 
-	if (argc != 2)
+	if (!parse_args(argc, argv, &opt))
 		ft_error(NULL, "arguments", NULL);
 	mlx_set_setting(MLX_MAXIMIZED, true);
 	mlx = mlx_init(WIDTH, HEIGHT, "FdF", true);
@@ -46,20 +47,23 @@ int	main(int argc, char *argv[])
 	img = mlx_new_image(mlx, mlx->width, mlx->height);
 	if (!img || mlx_image_to_window(mlx, img, 0, 0) == ERROR)
 		ft_error(mlx, "img alloc", NULL);
-	initialize(argv[1], &ctx, mlx, img);
+	initialize(&opt, &ctx, mlx, img);
 	mlx_loop_hook(mlx, loop, ctx);
 	mlx_key_hook(mlx, key_hook, ctx);
 	mlx_resize_hook(mlx, resize, ctx);
 	mlx_loop(mlx);
+	if (opt.mem_report)
+		memory_report(ctx);
 	mlx_terminate(mlx);
-	fdf_free(ctx->verts, ctx->tris, ctx);
+	fdf_free(ctx);
 	free(ctx);
 	return (EXIT_SUCCESS);
 }
 
 /**
  * Main loop for camera, rendering, and ui.
- * Iterates the values used for spin and color features.
+ * Iterates the values used for spin and color features. The ui is only
+ * updated along with the frames that are rendered.
  *
  * @param param Rendering context.
  */
@@ -88,8 +92,8 @@ static inline void	loop(void *param)
 		ctx->time_rot += ctx->mlx->delta_time;
 	}
 	time_color += ctx->mlx->delta_time;
-	render(ctx);
-	update_ui(ctx);
+	if (render(ctx))
+		update_ui(ctx);
 }
 
 /**
@@ -103,52 +107,19 @@ static inline void	loop(void *param)
 void	resize(int width, int height, void *param)
 {
 	t_context	*ctx;
+	ssize_t		size;
 
 	ctx = param;
 	if (!ctx || !ctx->mlx || !ctx->img || width == 0 || height == 0)
 		return ;
-	free(ctx->z_buf);
-	ctx->z_buf = malloc(sizeof(float) * width * height);
-	if (!ctx->z_buf || !mlx_resize_image(ctx->img, width, height))
+	size = (ssize_t)ctx->img->width * ctx->img->height;
+	if (!alloc_depth(ctx, width, height) ||
+		!mlx_resize_image(ctx->img, width, height))
 	{
-		fdf_free(ctx->verts, ctx->tris, ctx);
+		fdf_free(ctx);
 		ft_error(ctx->mlx, "resizing failed", ctx);
 	}
+	memory_track(ctx, MEM_IMAGE,
+		((ssize_t)width * height - size) * (ssize_t)sizeof(uint32_t));
 	frame(ctx);
 }
-
-/**
- * Logs errors on stderr and terminates mlx before exiting.
- *
- * @param mlx Mlx context.
- * @param message Error message.
- */
-void	ft_error(mlx_t *mlx, char *message, t_context *ctx)
-{
-	ft_putstr_fd("FdF:\tError: ", STDERR_FILENO);
-	ft_putendl_fd(message, STDERR_FILENO);
-	if (mlx)
-	{
-		ft_putstr_fd("MLX42:\t", STDERR_FILENO);
-		perror(mlx_strerror(mlx_errno));
-		mlx_terminate(mlx);
-	}
-	free(ctx);
-	exit(EXIT_FAILURE);
-}
-
-/**
- * Frees the rendering context, Z-buffer, and the `verts` `tris` vector arrays.
- * Should not be called with a vector that has not called vector_init()!
- * When a message is provided it means an error has occurred.
- *
- * @param verts Vertices vector array.
- * @param tris Triangles vector array.
- * @param ctx Rendering context containing Z-buffer.
- * @param message Error message.
- */
-void	fdf_free(t_vector *verts, t_vector *tris, t_context *ctx)
-{
-	vector_free(verts, tris, NULL);
-	free(ctx->z_buf);
-}
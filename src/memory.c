@@ -0,0 +1,112 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   memory.c                                           :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: myli-pen <myli-pen@student.hive.fi>        +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/18 00:32:34 by myli-pen          #+#    #+#             */
+/*   Updated: 2026/10/18 00:32:34 by myli-pen         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "fdf.h"
+
+static inline size_t	peak_rss(void);
+
+/**
+ * Accounts an allocation, or a release when `bytes` is negative, to one
+ * kind of memory, and raises the peak of that kind. Safe to call from the
+ * loader threads.
+ *
+ * The vertex store and the frame scratch are accounted by the bytes taken
+ * from their arenas, images and the Z-buffer by their pixels, and tiles by
+ * their resident pages (see `memory_report()`).
+ *
+ * @param ctx Rendering context.
+ * @param kind Kind of memory.
+ * @param bytes Bytes allocated, or released when negative.
+ */
+void	memory_track(t_context *ctx, t_mem_kind kind, ssize_t bytes)
+{
+	size_t	now;
+	size_t	peak;
+
+	now = atomic_fetch_add(&ctx->mem.bytes[kind], (size_t)bytes) +
+		(size_t)bytes;
+	peak = atomic_load(&ctx->mem.peak[kind]);
+	while (now > peak)
+		if (atomic_compare_exchange_weak(&ctx->mem.peak[kind], &peak, now))
+			peak = now;
+}
+
+/**
+ * Accounts the pixels of a newly created image.
+ *
+ * @param ctx Rendering context.
+ * @param img Image, may be NULL on allocation failure.
+ * @param kind Kind of memory.
+ * @return The image.
+ */
+mlx_image_t	*memory_image(t_context *ctx, mlx_image_t *img, t_mem_kind kind)
+{
+	if (img)
+		memory_track(ctx, kind,
+			(ssize_t)img->width * img->height * sizeof(uint32_t));
+	return (img);
+}
+
+/**
+ * Deletes an accounted image, if any, and clears its pointer.
+ *
+ * @param ctx Rendering context.
+ * @param img Image to delete.
+ * @param kind Kind of memory.
+ */
+void	memory_delete_image(t_context *ctx, mlx_image_t **img, t_mem_kind kind)
+{
+	if (!*img)
+		return ;
+	memory_track(ctx, kind,
+		-(ssize_t)((*img)->width * (*img)->height * sizeof(uint32_t)));
+	mlx_delete_image(ctx->mlx, *img);
+	*img = NULL;
+}
+
+/**
+ * Prints the memory in use and its peak for each kind of memory, and the
+ * peak resident set size of the process, in KiB. Printed on exit with
+ * `--mem-report`, and on demand with [M].
+ *
+ * @param ctx Rendering context.
+ */
+void	memory_report(t_context *ctx)
+{
+	const char	*names[MEM_KINDS] = {"vertices", "frame", "depth",
+		"image", "ui", "tiles"};
+	int			k;
+
+	ft_printf("FdF:\tMemory (KiB)\tin use\tpeak\n");
+	k = -1;
+	while (++k < MEM_KINDS)
+		ft_printf("\t%s\t%u\t%u\n", names[k],
+			(unsigned int)(atomic_load(&ctx->mem.bytes[k]) >> 10),
+			(unsigned int)(atomic_load(&ctx->mem.peak[k]) >> 10));
+	ft_printf("\tresident\t\t%u\n", (unsigned int)peak_rss());
+}
+
+/**
+ * Returns the peak resident set size of the process in KiB, which covers
+ * the memory of the libraries and the allocator the kinds above do not.
+ * macOS reports it in bytes, Linux in KiB.
+ *
+ * @return Peak resident set size in KiB.
+ */
+static inline size_t	peak_rss(void)
+{
+	struct rusage	usage;
+
+	if (getrusage(RUSAGE_SELF, &usage))
+		return (0);
+	return (usage.ru_maxrss >> RSS_SHIFT);
+}
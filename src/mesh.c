@@ -6,87 +6,181 @@
 /*   By: myli-pen <myli-pen@student.hive.fi>        +#+  +:+       +#+        */
 /*                                                +#+#+#+#+#+   +#+           */
 /*   Created: 2025/07/16 23:14:56 by myli-pen          #+#    #+#             */
-/*   Updated: 2025/08/09 00:34:52 by myli-pen         ###   ########.fr       */
+/*   Updated: 2026/10/18 04:04:16 by myli-pen         ###   ########.fr       */
 /*                                                                            */
 /* ************************************************************************** */
 
 #include "fdf.h"
 
+static void			*produce_rows(void *param);
+static inline void	draw_quads(t_worker *w, int row);
+
 /**
- * Creates a dynamically allocated vertex from given position and color.
- * Initializes its position, color, screen coordinates, and depth.
+ * Stores the vertex of a grid position at its index in the preallocated
+ * vertex store: its height and color, its x and y follow from the index.
+ * Maps drawn out of core store it in the tiles of their new cache instead
+ * (see `open_tiles()`).
  *
- * @param x X position in object space.
- * @param y Y position in object space (negated).
+ * @param ctx Rendering context containing the vertex storage.
+ * @param pos Column (x) and row (y) of the vertex, the row is negated.
  * @param z Z position in object space.
  * @param color Vertex color (32-bit RGBA).
- * @return Pointer to a new vertex.
+ * @return `true` on success, `false` on allocation failure.
  */
-t_vertex	*make_vert(float x, float y, float z, uint32_t color)
+bool	make_vert(t_context *ctx, t_vec2i pos, int z, uint32_t color)
 {
-	t_vertex	*v;
+	if (ctx->tiles.enabled)
+	{
+		tile_put(&ctx->tiles, pos, z, color);
+		return (true);
+	}
+	return (vert_put(ctx, (size_t)pos.y * ctx->rows_cols.y + pos.x, z,
+			color));
+}
 
-	v = malloc(sizeof(t_vertex));
-	if (!v)
-		return (NULL);
-	v->pos = vec4(x, -y, z, 1.0f);
-	v->color = color;
-	v->s = vec2i(0, 0);
-	v->depth = 0.0f;
-	return (v);
+/**
+ * Allocates the vertex store exactly once for the dimensions found by the
+ * loader. The edges of the grid follow from its dimensions, so no triangles
+ * are stored. Caches holding the store are drawn from as they are mapped
+ * instead (see `map_verts()`), only the tiles of caches written for maps
+ * drawn out of core are decoded.
+ *
+ * @param ctx Rendering context with `rows_cols` set.
+ * @return `true` on success, `false` on allocation failure.
+ */
+bool	alloc_mesh(t_context *ctx)
+{
+	if (ctx->load.from_cache && ((t_cache *)ctx->load.file.data)->z)
+	{
+		map_verts(ctx);
+		return (true);
+	}
+	if (!verts_alloc(&ctx->verts, ctx->rows_cols.x, ctx->rows_cols.y))
+		return (false);
+	memory_track(ctx, MEM_VERTS, ctx->verts.arena.used);
+	return (true);
 }
 
 /**
- * Divides a grid of vertices into triangles and stores the triangle vertex
- * indices as `vec3` structures inside the given `tris` vector.
- * Each quad formed by adjacent vertices is split into two triangles.
+ * Renders the wireframe grid straight from its rows and columns.
+ * Quad rows whose vertex rows are still being loaded are skipped.
+ *
+ * The quad rows are drawn in batches: each worker turns a range of quad
+ * rows of the batch into segments (see `produce_rows()`), then the workers
+ * draw the bands of the image (see `raster_segments()`). A batch holds about
+ * SEG_BATCH segments per worker, which bounds the scratch memory.
  *
- * @param tris Vector containing the generated triangles.
- * @param rows_cols A tuple containing number of vertex rows(x) and columns(y).
- * @return `true` on success, `false` if memory allocation fails.
+ * @param ctx Rendering context with the MVP matrix of the frame.
+ * @return `true` if the grid was drawn whole, `false` on allocation failure.
  */
-bool	make_triangles(t_vector *tris, t_vec2i rows_cols)
+bool	render_mesh(t_context *ctx)
 {
-	t_vec3	*tri;
-	t_quad	q;
-	int		row;
-	int		col;
-	size_t	i;
+	t_worker	*w;
+	bool		ok;
+	int			per;
+	int			row;
+	int			n;
 
-	i = 0;
-	while (i < (size_t)(rows_cols.x - 1) * ((rows_cols.y - 1) * 2))
+	per = ft_imax(1, SEG_BATCH / (4 * ctx->rows_cols.y));
+	ok = true;
+	row = 0;
+	while (row < ctx->rows_cols.x - 1)
 	{
-		row = i / (2 * (rows_cols.y - 1));
-		col = (i / 2) % (size_t)(rows_cols.y - 1);
-		q.topleft = row * rows_cols.y + col;
-		q.topright = q.topleft + 1;
-		q.bottomleft = q.topleft + rows_cols.y;
-		q.bottomright = q.bottomleft + 1;
-		if (i++ % 2 == 0)
-			tri = make_tri(q.topright, q.topleft, q.bottomleft);
-		else
-			tri = make_tri(q.bottomleft, q.bottomright, q.topright);
-		if (!tri || !vector_add(tris, tri))
-			return (false);
+		n = 0;
+		while (n < ctx->workers.threads && row < ctx->rows_cols.x - 1)
+		{
+			w = &ctx->workers.worker[n++];
+			w->rows = vec2i(row, ft_imin(row + per, ctx->rows_cols.x - 1));
+			row = w->rows.y;
+			if (!worker_scratch(w, (size_t)per * 4 * ctx->rows_cols.y))
+				return (false);
+		}
+		run_workers(ctx, n, produce_rows);
+		ok = raster_segments(ctx, n) && ok;
 	}
-	return (true);
+	return (ok);
 }
 
 /**
- * Creates a dynamically allocated triangle from given vertex indices.
+ * Thread routine turning the quad rows of a worker into binned segments.
+ *
+ * The range of the worker counts quad rows from the front of the grid, so
+ * the rows are drawn front to back (see `update_matrices()`), whichever way
+ * the grid faces.
+ *
+ * Every vertex row is transformed once into one of two rows of the
+ * post-transform buffer of the worker, by the parity of its index, and
+ * shared by the quad rows on both of its sides. The vertex rows bordering
+ * the range of another worker are transformed by both.
  *
- * @param x Index of the first vertex.
- * @param y Index of the second vertex
- * @param z Index of the third vertex
- * @return Pointer to a new triangle.
+ * @param param Worker with its range of quad rows set.
+ * @return NULL.
  */
-t_vec3	*make_tri(int x, int y, int z)
+static void	*produce_rows(void *param)
 {
-	t_vec3	*vec;
+	t_worker	*w;
+	int			cols;
+	int			held[2];
+	int			row;
+	int			i;
 
-	vec = malloc(sizeof(t_vec3));
-	if (!vec)
-		return (NULL);
-	*vec = vec3(x, y, z);
-	return (vec);
+	w = param;
+	cols = w->ctx->rows_cols.y;
+	ft_memset(held, -1, sizeof(held));
+	i = w->rows.x - 1;
+	while (++i < w->rows.y)
+	{
+		row = i + (w->ctx->m.order.y < 0) * (w->ctx->rows_cols.x - 2 - 2 * i);
+		if (!row_ready(w->ctx, row) || !row_ready(w->ctx, row + 1))
+			continue ;
+		if (held[row & 1] != row)
+			transform_row(w->ctx, row, w->post + (row & 1) * cols);
+		if (held[~row & 1] != row + 1)
+			transform_row(w->ctx, row + 1, w->post + (~row & 1) * cols);
+		held[row & 1] = row;
+		held[~row & 1] = row + 1;
+		draw_quads(w, row);
+	}
+	bin_segments(w);
+	return (NULL);
+}
+
+/**
+ * Draws the edges of a row of quads, between vertex rows `row` and
+ * `row + 1`, the way the two triangles splitting each quad would:
+ *
+ * - For every quad, the top and left edges are drawn.
+ *
+ * - For quads in the last row or last column, the bottom and right edges
+ * are drawn too, so the boundary lines are rendered.
+ *
+ * The quads are drawn front to back, like the rows.
+ *
+ * @param w Worker emitting the edges, with vertex rows `row` and `row + 1`
+ * transformed into its post-transform buffer.
+ * @param row Index of the quad row.
+ */
+static inline void	draw_quads(t_worker *w, int row)
+{
+	t_post	*top;
+	t_post	*bottom;
+	t_vec2i	rc;
+	int		col;
+	int		k;
+
+	rc = w->ctx->rows_cols;
+	top = w->post + (row & 1) * rc.y;
+	bottom = w->post + ((row + 1) & 1) * rc.y;
+	k = -1;
+	while (++k < rc.y - 1)
+	{
+		col = k + (w->ctx->m.order.x < 0) * (rc.y - 2 - 2 * k);
+		render_line(w, &top[col + 1], &top[col]);
+		render_line(w, &top[col], &bottom[col]);
+		if (row == rc.x - 2 || col == rc.y - 2)
+		{
+			render_line(w, &bottom[col], &bottom[col + 1]);
+			render_line(w, &bottom[col + 1], &top[col + 1]);
+		}
+	}
 }
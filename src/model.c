@@ -6,128 +6,101 @@
 /*   By: myli-pen <myli-pen@student.hive.fi>        +#+  +:+       +#+        */
 /*                                                +#+#+#+#+#+   +#+           */
 /*   Created: 2025/07/18 16:07:51 by myli-pen          #+#    #+#             */
-/*   Updated: 2025/08/22 22:05:28 by myli-pen         ###   ########.fr       */
+/*   Updated: 2026/10/18 04:03:04 by myli-pen         ###   ########.fr       */
 /*                                                                            */
 /* ************************************************************************** */
 
 #include "fdf.h"
 
-static inline void	init_context(t_context *ctx);
-static inline void	normalize_model(t_context *ctx);
-static inline void	alloc_model(t_vector **verts, t_vector **tris,
-						t_context **ctx, mlx_t *mlx);
+static inline void	init_context(t_context *ctx, mlx_t *mlx,
+						mlx_image_t *img);
+static inline void	alloc_model(t_context **ctx, mlx_t *mlx);
 
 /**
- * Parses the map file, initializes the vertex and triangle vectors,
- * constructs the triangle list, and allocates the main rendering context.
+ * Allocates the main rendering context, opens the map file or its binary
+ * cache, and starts the loader thread that fills the vertex store row by
+ * row.
  *
  * On failure, frees allocated resources and reports an error via `ft_error()`.
  *
- * @param file Path to the map file to load.
+ * @param opt Command line options with the path of the map file to load.
  * @param ctx Rendering context.
  * @param mlx Mlx context.
  * @param img Render image.
  */
-void	initialize(char *file, t_context **ctx, mlx_t *mlx, mlx_image_t *img)
+void	initialize(t_options *opt, t_context **ctx, mlx_t *mlx,
+			mlx_image_t *img)
 {
-	t_vector	*verts;
-	t_vector	*tris;
-	t_vec2i		rows_cols;
-
-	alloc_model(&verts, &tris, ctx, mlx);
-	if (!vector_init(verts, true) ||
-		parse_map(file, verts, &rows_cols) == ERROR || rows_cols.x < 2)
+	alloc_model(ctx, mlx);
+	if (!open_map(opt, *ctx))
 	{
-		free(tris);
-		vector_free(verts, NULL);
 		free((*ctx)->z_buf);
-		ft_error(mlx, "verts init || parse map", *ctx);
+		ft_error(mlx, "open map", *ctx);
 	}
-	if (!vector_init(tris, true) || !make_triangles(tris, rows_cols))
+	init_context(*ctx, mlx, img);
+	if (!start_loader(*ctx))
 	{
-		vector_free(verts, tris, NULL);
-		free((*ctx)->z_buf);
-		ft_error(mlx, "tris init/make", *ctx);
+		fdf_free(*ctx);
+		ft_error(mlx, "loader thread", *ctx);
 	}
-	(*ctx)->verts = verts;
-	(*ctx)->tris = tris;
-	(*ctx)->rows_cols = rows_cols;
-	(*ctx)->mlx = mlx;
-	(*ctx)->img = img;
-	init_context(*ctx);
 }
 
-static inline void	alloc_model(t_vector **verts, t_vector **tris,
-						t_context **ctx, mlx_t *mlx)
+static inline void	alloc_model(t_context **ctx, mlx_t *mlx)
 {
-	*verts = malloc(sizeof(t_vector));
-	*tris = malloc(sizeof(t_vector));
 	*ctx = malloc(sizeof(t_context));
-	if (!*verts || !*tris || !*ctx)
-	{
-		free(*verts);
-		free(*tris);
-		ft_error(mlx, "verts/tris/ctx alloc", NULL);
-	}
-	(*ctx)->z_buf = malloc(sizeof(float) * mlx->width * mlx->height);
-	if (!(*ctx)->z_buf)
-	{
-		free(*verts);
-		free(*tris);
+	if (!*ctx)
+		ft_error(mlx, "ctx alloc", NULL);
+	ft_bzero(&(*ctx)->mem, sizeof(t_memory));
+	(*ctx)->z_buf = NULL;
+	(*ctx)->hz.bytes = 0;
+	if (!alloc_depth(*ctx, mlx->width, mlx->height))
 		ft_error(mlx, "z-buf alloc", *ctx);
-	}
 }
 
 /**
- * Computes the axis-aligned bounding box of the model by
- * finding the minimum/maximum x, y, and z coordinates among all vertices.
+ * Allocates the Z-buffer of an image, along with its hierarchical Z-buffer
+ * (see `segment_hidden()` and `span_visible()`), in a single block freed
+ * with the Z-buffer. The previous block is freed first, and the change in
+ * size accounted as MEM_DEPTH.
  *
  * @param ctx Rendering context.
- * @param space Coordinate space in which bounds are computed (OBJECT or WORLD).
- * @param i Auxiliary starting index in the vertex array (always 0).
- * @param v Auxiliary vertex pointer.
+ * @param width Image width.
+ * @param height Image height.
+ * @return `true` on success, `false` on allocation failure.
  */
-void	compute_bounds(t_context *ctx, t_space space, size_t i, t_vertex *v)
+bool	alloc_depth(t_context *ctx, int width, int height)
 {
-	t_vec4	pos;
-	t_vec3	min;
-	t_vec3	max;
+	t_vec2i	size;
+	size_t	bytes;
 
-	min = vec3(FLT_MAX, FLT_MAX, FLT_MAX);
-	max = vec3(-FLT_MAX, -FLT_MAX, -FLT_MAX);
-	while (i < ctx->verts->total)
-	{
-		v = vector_get(ctx->verts, i++);
-		pos = v->pos;
-		if (space == WORLD)
-			pos = mat4_mul_vec4(ctx->m.m, v->pos);
-		min.x = fminf(min.x, pos.x);
-		min.y = fminf(min.y, pos.y);
-		min.z = fminf(min.z, pos.z);
-		max.x = fmaxf(max.x, pos.x);
-		max.y = fmaxf(max.y, pos.y);
-		max.z = fmaxf(max.z, pos.z);
-		if (space != OBJECT)
-			continue ;
-		ctx->alt_min_max.x = ft_imin(ctx->alt_min_max.x, pos.z);
-		ctx->alt_min_max.y = ft_imax(ctx->alt_min_max.y, pos.z);
-	}
-	ctx->center = vec3_scale(vec3_add(min, max), 0.5f);
-	ctx->bounds = vec3_sub(max, min);
+	size = vec2i((width + HZ_SIZE - 1) >> HZ_SHIFT,
+			(height + HZ_SIZE - 1) >> HZ_SHIFT);
+	bytes = sizeof(float) * ((size_t)width * height + size.x * size.y) +
+		(sizeof(uint16_t) + 1) * size.x * size.y;
+	free(ctx->z_buf);
+	ctx->z_buf = malloc(bytes);
+	memory_track(ctx, MEM_DEPTH, -(ssize_t)ctx->hz.bytes);
+	ctx->hz.bytes = 0;
+	if (!ctx->z_buf)
+		return (false);
+	memory_track(ctx, MEM_DEPTH, bytes);
+	ctx->hz.bytes = bytes;
+	ctx->hz.max = ctx->z_buf + (size_t)width * height;
+	ctx->hz.drawn = (uint16_t *)(ctx->hz.max + size.x * size.y);
+	ctx->hz.dirty = (uint8_t *)(ctx->hz.drawn + size.x * size.y);
+	ctx->hz.size = size;
+	return (true);
 }
 
 /**
- * Initializes the rendering context after loading vertices and triangles.
+ * Initializes the rendering context before the map is loaded.
  *
- * - Allocates and clears the Z-buffer.
+ * - Clears the Z-buffer.
  *
  * - Initializes default transform values (position, rotation, scale).
  *
- * - Computes initial object-space bounds and altitudes.
- *
- * - Normalizes the model (centers and rotates it).
- *
- * - Computes world-space bounds after normalization.
+ * - Sets placeholder bounds until the loader publishes the first rows, which
+ * computes the object-space bounds and frames the model (see `update_model()`).
  *
  * - Initializes the camera.
  *
@@ -135,51 +108,36 @@ void	compute_bounds(t_context *ctx, t_space space, size_t i, t_vertex *v)
  * @param mlx Mlx context.
  * @param img Render image.
  */
-static inline void	init_context(t_context *ctx)
+static inline void	init_context(t_context *ctx, mlx_t *mlx,
+						mlx_image_t *img)
 {
 	static size_t	i;
-	t_vertex		v;
 
+	ctx->mlx = mlx;
+	ctx->img = memory_image(ctx, img, MEM_IMAGE);
 	while (i < ctx->img->width * ctx->img->height)
 		ctx->z_buf[i++] = INFINITY;
 	ctx->transform.pos = vec3_n(0.0f);
 	ctx->transform.rot = vec3_n(0.0f);
 	ctx->transform.scale = vec3_n(1.0f);
-	ctx->alt_min_max = vec2i(INT_MAX, INT_MIN);
 	ctx->color_mode = DEFAULT;
-	ctx->color = WHITE;
 	ctx->time_rot = 0.0;
 	ctx->spin_mode = OFF;
-	compute_bounds(ctx, OBJECT, 0, &v);
-	if (ctx->alt_min_max.x == ctx->alt_min_max.y)
-		ctx->alt_min_max.y = ctx->alt_min_max.x + 1;
-	normalize_model(ctx);
-	ctx->m.m = model_matrix(ctx);
-	compute_bounds(ctx, WORLD, 0, &v);
+	ctx->rows_cols = vec2i(0, 0);
+	ft_bzero(&ctx->verts, sizeof(t_verts));
+	ctx->post = NULL;
+	ft_bzero(&ctx->frame, sizeof(t_arena));
+	ft_bzero(&ctx->view, sizeof(t_view));
+	ft_bzero(&ctx->tiles, sizeof(t_tiles));
+	init_workers(ctx);
+	ctx->alt_min_max = vec2i(0, 1);
+	ctx->o_center = vec3_n(0.0f);
+	ctx->o_bounds = vec3_n(1.0f);
+	ctx->center = vec3_n(0.0f);
+	ctx->bounds = vec3_n(1.0f);
 	init_camera(ctx);
 }
 
-/**
- * Normalizes the model by translating all vertices, placing the center
- * of the model at the world origin, and rotating it around the
- * X-axis by -90 degrees to align the model with the coordinate system.
- *
- * @param ctx Rendering context containing the model vertices.
- */
-static inline void	normalize_model(t_context *ctx)
-{
-	t_vertex	*v;
-	size_t		i;
-
-	i = 0;
-	while (i < ctx->verts->total)
-	{
-		v = vector_get(ctx->verts, i++);
-		v->pos = vec4_sub(v->pos, vec4_3(ctx->center, 0.0f));
-		v->pos = mat4_mul_vec4(mat4_rot_x(-M_PI_2), v->pos);
-	}
-}
-
 /**
  * Resets the model and camera to their default transform state:
  *
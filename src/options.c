@@ -0,0 +1,168 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   options.c                                          :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: myli-pen <myli-pen@student.hive.fi>        +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/17 23:09:03 by myli-pen          #+#    #+#             */
+/*   Updated: 2026/10/18 00:39:43 by myli-pen         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "fdf.h"
+
+static inline bool		parse_option(char **argv, int argc, int *i,
+							t_options *opt);
+static inline bool		parse_num(char **arg, size_t max, size_t *n);
+static inline bool		parse_raw(char *type, char *dims, t_options *opt);
+static inline t_format	file_format(char *file);
+
+/**
+ * Parses the command line:
+ * `fdf [--budget MiB] [--raw int16|uint16|float32 COLSxROWS] [--mem-report]
+ * map`
+ *
+ * The map `-` is read from the standard input (see `open_stream()`).
+ *
+ * - `--budget` sets the memory budget of the model in MiB, maps whose mesh
+ * exceeds it are drawn out of core from the tiles of their cache.
+ * Defaults to MEM_BUDGET.
+ *
+ * - `--raw` reads the map as a headerless grid of native-endian samples
+ * with the given dimensions.
+ *
+ * - `--mem-report` prints the memory used by each part of the renderer and
+ * the peak resident set size on exit (see `memory_report()`).
+ *
+ * Otherwise the format of the map follows its extension: `.pgm` for binary
+ * PGM, `.hgt` for SRTM tiles, anything else is read as FdF text.
+ *
+ * @param argc Arguments count.
+ * @param argv Arguments.
+ * @param opt Out options.
+ * @return `true` on success, `false` on invalid arguments.
+ */
+bool	parse_args(int argc, char **argv, t_options *opt)
+{
+	int	i;
+
+	opt->file = NULL;
+	opt->budget = (size_t)MEM_BUDGET << 20;
+	opt->format = FDF;
+	opt->dims = vec2i(0, 0);
+	opt->mem_report = false;
+	i = 0;
+	while (++i < argc)
+	{
+		if (argv[i][0] == '-' && argv[i][1])
+		{
+			if (!parse_option(argv, argc, &i, opt))
+				return (false);
+		}
+		else if (opt->file)
+			return (false);
+		else
+			opt->file = argv[i];
+	}
+	if (opt->file && !opt->dims.x)
+		opt->format = file_format(opt->file);
+	return (opt->file != NULL);
+}
+
+/**
+ * Parses an option and its values, advancing past them.
+ *
+ * @param argv Arguments.
+ * @param argc Arguments count.
+ * @param i Index of the option, out index of its last value.
+ * @param opt Options to set.
+ * @return `true` on success, `false` on unknown options or invalid values.
+ */
+static inline bool	parse_option(char **argv, int argc, int *i,
+						t_options *opt)
+{
+	size_t	mib;
+
+	if (!ft_strncmp(argv[*i], "--budget", 9) && *i + 1 < argc)
+	{
+		if (!parse_num(&argv[++*i], (size_t)1 << 40, &mib) || *argv[*i])
+			return (false);
+		opt->budget = mib << 20;
+		return (true);
+	}
+	if (!ft_strncmp(argv[*i], "--raw", 6) && *i + 2 < argc)
+	{
+		*i += 2;
+		return (parse_raw(argv[*i - 1], argv[*i], opt));
+	}
+	if (!ft_strncmp(argv[*i], "--mem-report", 13))
+	{
+		opt->mem_report = true;
+		return (true);
+	}
+	return (false);
+}
+
+/**
+ * Parses a positive decimal number, advancing past its digits.
+ *
+ * @param arg Pointer to the start of the number.
+ * @param max Largest accepted number.
+ * @param n Out number.
+ * @return `true` on success, `false` if the number is zero, missing or
+ * too large.
+ */
+static inline bool	parse_num(char **arg, size_t max, size_t *n)
+{
+	*n = 0;
+	while (ft_isdigit(**arg) && *n <= max)
+		*n = *n * 10 + *(*arg)++ - '0';
+	return (*n > 0 && *n <= max);
+}
+
+/**
+ * Parses the sample type and the dimensions of a raw map.
+ *
+ * @param type `int16`, `uint16` or `float32`.
+ * @param dims Columns and rows, e.g. "1024x768".
+ * @param opt Options to set.
+ * @return `true` on success, `false` on invalid values.
+ */
+static inline bool	parse_raw(char *type, char *dims, t_options *opt)
+{
+	size_t	cols;
+	size_t	rows;
+
+	if (!ft_strncmp(type, "int16", 6))
+		opt->format = RAW_INT16;
+	else if (!ft_strncmp(type, "uint16", 7))
+		opt->format = RAW_UINT16;
+	else if (!ft_strncmp(type, "float32", 8))
+		opt->format = RAW_FLOAT32;
+	else
+		return (false);
+	if (!parse_num(&dims, INT_MAX, &cols) || *dims++ != 'x' ||
+		!parse_num(&dims, INT_MAX, &rows) || *dims)
+		return (false);
+	opt->dims = vec2i(rows, cols);
+	return (true);
+}
+
+/**
+ * Picks the format of a map from its extension.
+ *
+ * @param file Path to the map file.
+ * @return PGM, HGT, or FDF for any other extension.
+ */
+static inline t_format	file_format(char *file)
+{
+	size_t	len;
+
+	len = ft_strlen(file);
+	if (len >= 4 && !ft_strncmp(file + len - 4, ".pgm", 4))
+		return (PGM);
+	if (len >= 4 && !ft_strncmp(file + len - 4, ".hgt", 4))
+		return (HGT);
+	return (FDF);
+}
@@ -6,169 +6,156 @@
 /*   By: myli-pen <myli-pen@student.hive.fi>        +#+  +:+       +#+        */
 /*                                                +#+#+#+#+#+   +#+           */
 /*   Created: 2025/07/16 23:04:16 by myli-pen          #+#    #+#             */
-/*   Updated: 2025/08/22 23:49:30 by myli-pen         ###   ########.fr       */
+/*   Updated: 2026/10/17 23:53:29 by myli-pen         ###   ########.fr       */
 /*                                                                            */
 /* ************************************************************************** */
 
 #include "fdf.h"
 
-static inline int			parse_data(char **elem, t_vector *verts, int row);
-static inline int			init_line(char *line, char ***elements);
-static inline uint32_t	parse_color(char *str);
-static inline void		free_parse(char *line, char **elements);
+static inline bool	parse_elem(t_chunk *chunk, int *z, uint32_t *color);
+static inline bool	store_vert(t_chunk *chunk, t_vec2i pos, int z,
+						uint32_t color);
 
 /**
- * Parses a map file into a vector of vertices.
+ * Parses the mapped map file into the vertex vector. Runs on the loader
+ * thread.
  *
  * The map file must have matching width and height values as dimensions.
  *
- * Reads a heightmap file line by line, parsing each line into vertex data.
+ * The file is tokenized in place, so no intermediate strings are allocated
+ * for lines, elements or colors.
+ * A pre-scan splits the file on newline boundaries into row ranges and
+ * counts the columns of the first row, so the vertex store can be sized up
+ * front. Large files are then parsed in parallel, each range by its own
+ * thread, into its own slice of the store. Every completed row is published
+ * to the renderer.
+ *
  * Each vertex can optionally have a color.
- * The resulting vertices are stored in `verts`,
- * and the number of rows and columns is stored in `rows_cols`.
  *
- * @param map Path to the map file.
- * @param verts Vector where vertices will be stored.
- * @param rows_cols Structure to store rows (x) and columns (y).
- * @return `true` on success, or ERROR on failure.
+ * @param ctx Rendering context containing the mapped file and the vectors.
+ * @return `true` on success, `false` on failure.
  */
-int	parse_map(char *map, t_vector *verts, t_vec2i *rows_cols)
+bool	parse_map(t_context *ctx)
 {
-	char	*line;
-	char	**elements;
-	int		fd;
-	int		col;
+	t_chunk	chunks[THREADS_MAX];
+	int		n;
 
-	fd = open(map, O_RDONLY);
-	if (fd == ERROR || get_next_line(fd, &line) != GNL_OK)
-		return (close(fd), ERROR);
-	rows_cols->x = 0;
-	while (line)
-	{
-		if (init_line(line, &elements) == ERROR)
-			return (close(fd), free_parse(line, elements), ERROR);
-		col = parse_data(elements, verts, rows_cols->x);
-		if (col == ERROR || (rows_cols->x && col != rows_cols->y))
-			return (close(fd), free_parse(line, elements), ERROR);
-		rows_cols->x++;
-		rows_cols->y = col;
-		free_parse(line, elements);
-		if (get_next_line(fd, &line) == GNL_ERROR)
-			return (close(fd), free_parse(line, elements), ERROR);
-	}
-	return (close(fd), true);
+	n = split_chunks(&ctx->load.file, chunks);
+	ctx->rows_cols.x = chunks[n - 1].row + chunks[n - 1].rows;
+	ctx->rows_cols.y = count_cols(&ctx->load.file);
+	if (!alloc_rows(ctx))
+		return (false);
+	return (run_chunks(chunks, n, ctx));
 }
 
 /**
- * Prepares a line for parsing by trimming and splitting.
+ * Parses a row of space separated map elements into vertices.
  *
- * Removes the trailing newline character, and splits the line into
- * elements separated by spaces.
+ * Consumes the line including its terminating newline, if any.
+ * Vertices are stored by index into the slice of the vertex vector that
+ * belongs to the row, so rows can be parsed in any order. Parsing stops as
+ * soon as the row has more elements than the first row.
  *
- * @param line The input line from the map file.
- * @param elements Output pointer to an array of split string elements.
- * @return true on success, or ERROR on allocation failure.
+ * @param chunk Row range with a cursor positioned at the start of the line.
+ * @param row Current row index, used as (y) for the vertex.
+ * @return Number of columns parsed, or ERROR on failure.
  */
-static inline int	init_line(char *line, char ***elements)
+int	parse_line(t_chunk *chunk, int row)
 {
-	size_t	len;
+	uint32_t	color;
+	int			col;
+	int			z;
 
-	*elements = NULL;
-	len = ft_strlen(line);
-	if (len < 1)
-		return (ERROR);
-	if (line[len - 1] == '\n')
-		line[len - 1] = '\0';
-	*elements = ft_split(line, ' ');
-	if (!*elements)
-		return (ERROR);
-	len = 0;
-	while ((*elements)[len])
-		++len;
-	if (len < 2)
-		return (ERROR);
-	return (true);
+	col = 0;
+	while (chunk->cur.ptr < chunk->cur.end && *chunk->cur.ptr != '\n')
+	{
+		chunk->cur.ptr = scan_skip(&chunk->scan, chunk->cur.ptr);
+		if (chunk->cur.ptr == chunk->cur.end || *chunk->cur.ptr == '\n')
+			break ;
+		if (col == chunk->ctx->rows_cols.y ||
+			!parse_elem(chunk, &z, &color) ||
+			!store_vert(chunk, vec2i(col++, row), z, color))
+			return (ERROR);
+	}
+	if (chunk->cur.ptr < chunk->cur.end)
+		++chunk->cur.ptr;
+	return (col);
 }
 
 /**
- * Frees resources allocated during parsing.
+ * Parses a single map element into a height and an optional color.
+ *
+ * The element spans up to the next space or newline, found by the
+ * structural scanner of the row range. It is split on commas in place: the
+ * first word is the height, and the second word, if present, must be a color
+ * with a `0x` prefix.
  *
- * @param line Current line string.
- * @param elements Array of strings.
+ * @param chunk Row range with its cursor positioned at the element,
+ * advanced past it.
+ * @param z Out height.
+ * @param color Out color, WHITE if not given.
+ * @return `true` on success, `false` if the element is malformed.
  */
-static inline void	free_parse(char *line, char **elements)
+static inline bool	parse_elem(t_chunk *chunk, int *z, uint32_t *color)
 {
-	if (elements)
-		ft_free_split(elements);
-	free(line);
+	t_cursor	elem;
+	t_cursor	word;
+
+	elem.ptr = chunk->cur.ptr;
+	chunk->cur.ptr = scan_sep(&chunk->scan, chunk->cur.ptr);
+	elem.end = chunk->cur.ptr;
+	if (!next_word(&elem, &word))
+		return (false);
+	*z = parse_int(word);
+	*color = WHITE;
+	if (!next_word(&elem, &word))
+		return (true);
+	if (word.end - word.ptr < 2 || word.ptr[0] != '0' || word.ptr[1] != 'x')
+		return (false);
+	word.ptr += 2;
+	*color = parse_hex(word);
+	return (true);
 }
 
 /**
- * Parses a row of map elements into vertices.
- *
- * For each element in the row, this function splits the string into a height
- * and optional color. A new vertex is created and added to the vertex vector.
+ * Creates a vertex and stores it at its grid position in the vertex vector.
+ * Extends the altitude range of the row range.
  *
- * @param elem Array of strings representing height and optional color.
- * @param verts Vector where parsed vertices are added.
- * @param row Current row index, used as (y) for the vertex.
- * @return Number of columns parsed, or ERROR on failure.
+ * @param chunk Row range being parsed.
+ * @param pos Column (x) and row (y) of the vertex.
+ * @param z Height of the vertex.
+ * @param color Color of the vertex.
+ * @return `true` on success, `false` on allocation failure.
  */
-static inline int	parse_data(char **elem, t_vector *verts, int row)
+static inline bool	store_vert(t_chunk *chunk, t_vec2i pos, int z,
+						uint32_t color)
 {
-	char		**data;
-	uint32_t	color;
-	int			col;
-	t_vertex	*vert;
-
-	col = 0;
-	while (elem[col])
-	{
-		color = WHITE;
-		data = ft_split(elem[col], ',');
-		if (!data)
-			return (ERROR);
-		if (data[1] && !ft_strnstr(data[1], "0x", 2))
-			return (ft_free_split(data), ERROR);
-		if (data[1])
-			color = parse_color(data[1]);
-		vert = make_vert(col++, row, ft_atoi(data[0]), color);
-		if (!vert)
-			return (ft_free_split(data), ERROR);
-		if (!vector_add(verts, vert))
-			return (ft_free_split(data), ERROR);
-		ft_free_split(data);
-	}
-	return (col);
+	chunk->alt.x = ft_imin(chunk->alt.x, z);
+	chunk->alt.y = ft_imax(chunk->alt.y, z);
+	return (make_vert(chunk->ctx, pos, z, color));
 }
 
 /**
- * Converts a color string in hex format to a 32-bit RGBA value.
+ * Counts the space separated elements on the first line of the map.
+ * Every other row must have the same number of columns.
  *
- * @param str The color string in case-insensitive hex format.
- * @return 32-bit RGBA color, or ERROR_COLOR on failure.
+ * @param file Mapped map file, or the start of a streamed map.
+ * @return Number of columns of the first row.
  */
-static inline uint32_t	parse_color(char *str)
+int	count_cols(t_file *file)
 {
-	uint32_t	color;
-	char		*trimmed;
-	char		padded[9];
-	size_t		len;
+	const char	*ptr;
+	const char	*end;
+	int			cols;
 
-	ft_memset(padded, '0', 8);
-	padded[8] = '\0';
-	trimmed = ft_strchr(str + 2, '\n');
-	if (trimmed)
-		*trimmed = '\0';
-	trimmed = str + 2;
-	ft_striteri(trimmed, ft_toupper);
-	len = ft_strlen(trimmed);
-	if (len >= 2 && len <= 8)
-		ft_memcpy(padded, trimmed, len);
-	else
-		return (ERROR_COLOR);
-	color = ft_atouint32_t_base(padded, BASE_16);
-	if ((color & 0xFF) == 0)
-		color |= 0xFF;
-	return (color);
+	ptr = file->data;
+	end = file->data + file->size;
+	cols = 0;
+	while (ptr < end && *ptr != '\n')
+	{
+		if (*ptr != ' ' && (ptr == file->data || ptr[-1] == ' '))
+			++cols;
+		++ptr;
+	}
+	return (cols);
 }
@@ -0,0 +1,160 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   pool.c                                             :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: myli-pen <myli-pen@student.hive.fi>        +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/18 02:47:51 by myli-pen          #+#    #+#             */
+/*   Updated: 2026/10/18 02:47:51 by myli-pen         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "fdf.h"
+
+static void			*pool_loop(void *param);
+static inline void	hand_out(t_workers *pool, int n, void *(*routine)(void *));
+
+/**
+ * Starts the threads of the workers other than the first, which runs on
+ * the calling thread. They are parked between the jobs handed out by
+ * `run_workers()`, and live until `stop_pool()`. Threads are started in
+ * order until one cannot be, the workers past it run on the calling thread.
+ *
+ * @param ctx Rendering context with the number of workers set.
+ */
+void	start_pool(t_context *ctx)
+{
+	t_workers	*pool;
+
+	pool = &ctx->workers;
+	pool->routine = NULL;
+	pool->running = 0;
+	pool->pending = 0;
+	pool->job = 0;
+	pool->quit = false;
+	pool->started = 0;
+	if (pthread_mutex_init(&pool->lock, NULL) != 0 ||
+		pthread_cond_init(&pool->start, NULL) != 0 ||
+		pthread_cond_init(&pool->done, NULL) != 0)
+		return ;
+	pool->started = 1;
+	while (pool->started < pool->threads && pthread_create(
+			&pool->worker[pool->started].thread, NULL, pool_loop,
+			&pool->worker[pool->started]) == 0)
+		++pool->started;
+}
+
+/**
+ * Runs a routine on the first `n` workers, and returns once all of them
+ * are done. The first worker runs on the calling thread, as do the workers
+ * with no thread, after it.
+ *
+ * @param ctx Rendering context.
+ * @param n Number of workers.
+ * @param routine Routine, given the worker.
+ */
+void	run_workers(t_context *ctx, int n, void *(*routine)(void *))
+{
+	t_workers	*pool;
+	int			pooled;
+	int			k;
+
+	pool = &ctx->workers;
+	pooled = ft_imax(1, ft_imin(n, pool->started));
+	if (pooled > 1)
+		hand_out(pool, pooled, routine);
+	routine(&pool->worker[0]);
+	k = pooled - 1;
+	while (++k < n)
+		routine(&pool->worker[k]);
+	if (pooled < 2)
+		return ;
+	pthread_mutex_lock(&pool->lock);
+	while (pool->pending)
+		pthread_cond_wait(&pool->done, &pool->lock);
+	pthread_mutex_unlock(&pool->lock);
+}
+
+/**
+ * Wakes the threads of the workers up to quit, and joins them.
+ *
+ * @param ctx Rendering context.
+ */
+void	stop_pool(t_context *ctx)
+{
+	t_workers	*pool;
+	int			k;
+
+	pool = &ctx->workers;
+	if (!pool->started)
+		return ;
+	pthread_mutex_lock(&pool->lock);
+	pool->quit = true;
+	pthread_cond_broadcast(&pool->start);
+	pthread_mutex_unlock(&pool->lock);
+	k = 0;
+	while (++k < pool->started)
+		pthread_join(pool->worker[k].thread, NULL);
+	pthread_mutex_destroy(&pool->lock);
+	pthread_cond_destroy(&pool->start);
+	pthread_cond_destroy(&pool->done);
+	pool->started = 0;
+}
+
+/**
+ * Hands a routine out to the threads of the workers 1 to `n` (excluded),
+ * as a new job.
+ *
+ * @param pool Workers.
+ * @param n Number of workers running the routine, all with a thread.
+ * @param routine Routine, given the worker.
+ */
+static inline void	hand_out(t_workers *pool, int n, void *(*routine)(void *))
+{
+	pthread_mutex_lock(&pool->lock);
+	pool->routine = routine;
+	pool->running = n;
+	pool->pending = n - 1;
+	++pool->job;
+	pthread_cond_broadcast(&pool->start);
+	pthread_mutex_unlock(&pool->lock);
+}
+
+/**
+ * Thread routine of a worker of the pool: waits for a new job, runs its
+ * routine if the worker is part of it, and reports back, until the pool
+ * quits. The job is only handed out once the previous one is done, so a
+ * worker that is part of it cannot miss it.
+ *
+ * @param param Worker.
+ * @return NULL.
+ */
+static void	*pool_loop(void *param)
+{
+	t_worker	*w;
+	t_workers	*pool;
+	int			job;
+
+	w = param;
+	pool = &w->ctx->workers;
+	job = 0;
+	pthread_mutex_lock(&pool->lock);
+	while (!pool->quit)
+	{
+		if (pool->job == job || w - pool->worker >= pool->running)
+		{
+			job = pool->job;
+			pthread_cond_wait(&pool->start, &pool->lock);
+			continue ;
+		}
+		job = pool->job;
+		pthread_mutex_unlock(&pool->lock);
+		pool->routine(w);
+		pthread_mutex_lock(&pool->lock);
+		if (--pool->pending == 0)
+			pthread_cond_signal(&pool->done);
+	}
+	pthread_mutex_unlock(&pool->lock);
+	return (NULL);
+}
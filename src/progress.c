@@ -0,0 +1,150 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   progress.c                                         :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: myli-pen <myli-pen@student.hive.fi>        +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/17 22:34:26 by myli-pen          #+#    #+#             */
+/*   Updated: 2026/10/18 02:59:54 by myli-pen         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "fdf.h"
+
+static inline void	update_bounds(t_context *ctx, t_vec2i alt);
+
+/**
+ * Picks up the progress of the loader thread on the main loop.
+ *
+ * Once the dimensions are known the published rows can be rendered. Whenever
+ * new rows extend the altitude range, the object-space bounds are updated
+ * and the model is framed again. A failed load terminates the program.
+ * Streamed maps also grow their rows here (see `sync_stream()`).
+ *
+ * @param ctx Rendering context.
+ * @return `true` if the model can be rendered, `false` while still scanning.
+ */
+bool	update_model(t_context *ctx)
+{
+	int		state;
+	t_vec2i	alt;
+	bool	changed;
+
+	if (ctx->load.finished)
+		return (true);
+	state = atomic_load(&ctx->load.state);
+	if (state == LOAD_FAILED)
+	{
+		fdf_free(ctx);
+		ft_error(ctx->mlx, "verts init || parse map", ctx);
+	}
+	if (state == LOAD_SCANNING)
+		return (false);
+	pthread_mutex_lock(&ctx->load.lock);
+	alt = ctx->load.alt;
+	changed = ctx->load.changed;
+	ctx->load.changed = false;
+	if (ctx->load.stream)
+		sync_stream(ctx, state);
+	pthread_mutex_unlock(&ctx->load.lock);
+	ctx->load.finished = state == LOAD_DONE;
+	if (changed)
+		update_bounds(ctx, alt);
+	return (true);
+}
+
+/**
+ * Checks if a row has been published by the loader and can be drawn.
+ *
+ * @param ctx Rendering context.
+ * @param row Row index.
+ * @return `true` if the vertices of the row are complete.
+ */
+bool	row_ready(t_context *ctx, int row)
+{
+	if (ctx->load.finished)
+		return (true);
+	if (row >= ctx->rows_cols.x)
+		return (false);
+	return (atomic_load_explicit(&ctx->load.ready[row], memory_order_acquire));
+}
+
+/**
+ * Computes the axis-aligned bounding box of the model in object space.
+ * The grid spans the columns in X and the negated rows in Y, so only the
+ * altitude range has to be gathered from the vertices.
+ *
+ * @param ctx Rendering context containing the grid dimensions.
+ * @param alt Altitude range of the model.
+ * @param center Out center of the bounding box.
+ * @param bounds Out size of the bounding box.
+ */
+void	object_bounds(t_context *ctx, t_vec2i alt,
+			t_vec3 *center, t_vec3 *bounds)
+{
+	t_vec3	min;
+	t_vec3	max;
+
+	min = vec3(0.0f, -(ctx->rows_cols.x - 1), alt.x);
+	max = vec3(ctx->rows_cols.y - 1, 0.0f, alt.y);
+	*center = vec3_scale(vec3_add(min, max), 0.5f);
+	*bounds = vec3_sub(max, min);
+}
+
+/**
+ * Computes the world-space bounds of the model from the eight corners of its
+ * object-space bounding box, without visiting the vertices.
+ *
+ * @param ctx Rendering context with the model matrix of the frame.
+ */
+void	box_bounds(t_context *ctx)
+{
+	t_vec3	box[2];
+	t_vec4	pos;
+	t_vec3	min;
+	t_vec3	max;
+	int		k;
+
+	box[0] = vec3_sub(ctx->o_center, vec3_scale(ctx->o_bounds, 0.5f));
+	box[1] = vec3_add(ctx->o_center, vec3_scale(ctx->o_bounds, 0.5f));
+	min = vec3(FLT_MAX, FLT_MAX, FLT_MAX);
+	max = vec3(-FLT_MAX, -FLT_MAX, -FLT_MAX);
+	k = -1;
+	while (++k < 8)
+	{
+		pos = mat4_mul_vec4(ctx->m.m, vec4(box[k & 1].x,
+					box[(k >> 1) & 1].y, box[k >> 2].z, 1.0f));
+		min = vec3(fminf(min.x, pos.x), fminf(min.y, pos.y),
+				fminf(min.z, pos.z));
+		max = vec3(fmaxf(max.x, pos.x), fmaxf(max.y, pos.y),
+				fmaxf(max.z, pos.z));
+	}
+	ctx->center = vec3_scale(vec3_add(min, max), 0.5f);
+	ctx->bounds = vec3_sub(max, min);
+}
+
+/**
+ * Applies a new altitude range: updates the object-space bounds that center
+ * the model, the altitude range used for coloring, and frames the model.
+ * Maps loaded from their cache take the bounds stored in it.
+ *
+ * @param ctx Rendering context.
+ * @param alt Altitude range of the rows loaded so far.
+ */
+static inline void	update_bounds(t_context *ctx, t_vec2i alt)
+{
+	if (ctx->load.boxed)
+	{
+		ctx->o_center = ctx->load.center;
+		ctx->o_bounds = ctx->load.bounds;
+	}
+	else
+		object_bounds(ctx, alt, &ctx->o_center, &ctx->o_bounds);
+	if (alt.x == alt.y)
+		alt.y = alt.x + 1;
+	ctx->alt_min_max = alt;
+	ctx->load.visible = true;
+	frame(ctx);
+	ctx->cam.far = 8.0f * ctx->cam.distance;
+}
@@ -6,7 +6,7 @@
 /*   By: myli-pen <myli-pen@student.hive.fi>        +#+  +:+       +#+        */
 /*                                                +#+#+#+#+#+   +#+           */
 /*   Created: 2025/07/16 23:18:33 by myli-pen          #+#    #+#             */
-/*   Updated: 2025/07/29 12:40:15 by myli-pen         ###   ########.fr       */
+/*   Updated: 2026/10/17 22:37:22 by myli-pen         ###   ########.fr       */
 /*                                                                            */
 /* ************************************************************************** */
 
@@ -49,6 +49,10 @@ bool	project_to_screen(t_vertex *vert, t_context *ctx)
  * Builds the model matrix for the current transformation by combining
  * translation, rotation, and scaling into a single matrix.
  *
+ * The model is normalized first: its object-space center is moved to the
+ * origin and it is rotated around the X-axis by -90 degrees, so the map
+ * lies flat with the altitude pointing up.
+ *
  * @param ctx Rendering context containing the model's transform.
  * @return The resulting 4x4 model matrix.
  */
@@ -59,7 +63,9 @@ t_mat4	model_matrix(t_context *ctx)
 	m.t = mat4_translate(ctx->transform.pos);
 	m.r = mat4_rot(ctx->transform.rot);
 	m.s = mat4_scale(ctx->transform.scale);
-	m.m = mat4_mul(mat4_mul(m.t, m.r), m.s);
+	m.n = mat4_mul(mat4_rot_x(-M_PI_2),
+			mat4_translate(vec3_scale(ctx->o_center, -1.0f)));
+	m.m = mat4_mul(mat4_mul(mat4_mul(m.t, m.r), m.s), m.n);
 	return (m.m);
 }
 
@@ -0,0 +1,135 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   raster.c                                           :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: myli-pen <myli-pen@student.hive.fi>        +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/17 23:23:46 by myli-pen          #+#    #+#             */
+/*   Updated: 2026/10/17 23:23:46 by myli-pen         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "fdf.h"
+
+static inline bool	pgm_header(t_file *file, t_raster *raster);
+static inline bool	pgm_number(t_cursor *cur, size_t *n);
+static inline bool	pgm_space(char c);
+
+/**
+ * Locates the samples of a mapped binary heightmap and finds its dimensions.
+ *
+ * - PGM: binary P5 graymap, 8-bit or big-endian 16-bit by its maximum value.
+ *
+ * - HGT: SRTM tile, a square grid of big-endian 16-bit samples.
+ *
+ * - RAW: headerless grid of native-endian samples, dimensions given on the
+ * command line.
+ *
+ * @param ctx Rendering context with the options and the mapped file.
+ * @param raster Out samples, dimensions and sample type.
+ * @return `true` if the file holds a complete grid, `false` otherwise.
+ */
+bool	raster_init(t_context *ctx, t_raster *raster)
+{
+	t_file	*file;
+	size_t	n;
+
+	file = &ctx->load.file;
+	if (ctx->opt.format == PGM)
+		return (pgm_header(file, raster));
+	raster->data = (const uint8_t *)file->data;
+	raster->rows_cols = ctx->opt.dims;
+	raster->sample = SAMPLE_I16;
+	if (ctx->opt.format == RAW_UINT16)
+		raster->sample = SAMPLE_U16;
+	else if (ctx->opt.format == RAW_FLOAT32)
+		raster->sample = SAMPLE_F32;
+	if (ctx->opt.format == HGT)
+	{
+		n = sqrt(file->size / 2);
+		raster->rows_cols = vec2i(n, n);
+		raster->sample = SAMPLE_I16_BE;
+		return (n * n * 2 == file->size);
+	}
+	n = (size_t)raster->rows_cols.x * raster->rows_cols.y;
+	return (file->size == n * (2 + 2 * (raster->sample == SAMPLE_F32)));
+}
+
+/**
+ * Parses the header of a binary PGM: the `P5` magic number, the width, the
+ * height and the maximum value, separated by whitespace and comments, and
+ * followed by a single whitespace character before the samples.
+ *
+ * @param file Mapped PGM file.
+ * @param raster Out samples, dimensions and sample type.
+ * @return `true` on success, `false` on malformed or truncated files.
+ */
+static inline bool	pgm_header(t_file *file, t_raster *raster)
+{
+	t_cursor	cur;
+	size_t		cols;
+	size_t		rows;
+	size_t		maxval;
+
+	cur = (t_cursor){file->data, file->data + file->size};
+	if (file->size < 2 || cur.ptr[0] != 'P' || cur.ptr[1] != '5')
+		return (false);
+	cur.ptr += 2;
+	if (!pgm_number(&cur, &cols) || !pgm_number(&cur, &rows) ||
+		!pgm_number(&cur, &maxval) || maxval > UINT16_MAX ||
+		cur.ptr == cur.end || !pgm_space(*cur.ptr++))
+		return (false);
+	raster->data = (const uint8_t *)cur.ptr;
+	raster->rows_cols = vec2i(rows, cols);
+	raster->sample = SAMPLE_U8;
+	if (maxval > UINT8_MAX)
+		raster->sample = SAMPLE_U16_BE;
+	return ((size_t)(cur.end - cur.ptr) >= rows * cols * (1 + (maxval > 255)));
+}
+
+/**
+ * Parses a positive decimal number of a PGM header, preceded by whitespace
+ * and comments running from `#` to the end of the line.
+ *
+ * @param cur Cursor positioned after the previous token, advanced past the
+ * number.
+ * @param n Out number.
+ * @return `true` on success, `false` if the number is missing, zero or too
+ * large.
+ */
+static inline bool	pgm_number(t_cursor *cur, size_t *n)
+{
+	const char	*start;
+	bool		comment;
+
+	start = cur->ptr;
+	comment = false;
+	while (cur->ptr < cur->end &&
+		(comment || pgm_space(*cur->ptr) || *cur->ptr == '#'))
+	{
+		if (*cur->ptr == '#')
+			comment = true;
+		else if (*cur->ptr == '\n')
+			comment = false;
+		++cur->ptr;
+	}
+	if (cur->ptr == start)
+		return (false);
+	*n = 0;
+	while (cur->ptr < cur->end && ft_isdigit(*cur->ptr) && *n <= INT_MAX)
+		*n = *n * 10 + *cur->ptr++ - '0';
+	return (*n > 0 && *n <= INT_MAX);
+}
+
+/**
+ * Checks for a whitespace character of a PGM header.
+ *
+ * @param c Character.
+ * @return `true` for space, tab, newline, vertical tab, form feed and
+ * carriage return.
+ */
+static inline bool	pgm_space(char c)
+{
+	return (c == ' ' || (c >= '\t' && c <= '\r'));
+}
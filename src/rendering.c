@@ -6,193 +6,165 @@
 /*   By: myli-pen <myli-pen@student.hive.fi>        +#+  +:+       +#+        */
 /*                                                +#+#+#+#+#+   +#+           */
 /*   Created: 2025/07/16 23:08:26 by myli-pen          #+#    #+#             */
-/*   Updated: 2025/07/31 01:53:48 by myli-pen         ###   ########.fr       */
+/*   Updated: 2026/10/18 04:04:16 by myli-pen         ###   ########.fr       */
 /*                                                                            */
 /* ************************************************************************** */
 
 #include "fdf.h"
 
-static inline void	render_line(
-						t_context *ctx, int idx0, int idx1);
-static inline void	draw_line(
-						t_context *ctx, t_vertex v0, t_vertex v1);
-static inline void	move_pixel(
-						t_vec2i *d, t_vec2i *s, int *error, t_vertex *v0);
-static inline void	draw_pixel(
-						t_context *ctx, t_vertex v0, uint32_t c);
+static inline void	split_bands(t_context *ctx);
+static inline void	emit_segment(t_worker *w, t_vertex *v0, t_vertex *v1);
 
 /**
- * Renders the wireframe grid from the triangle list.
+ * Renders the wireframe grid of the model.
  *
- * Clears the render image first to a solid color and default the Z-buffer.
+ * Picks up the progress of the loader first. Once the map is loaded, frames
+ * whose view did not change since the last rendered one are skipped, leaving
+ * the image in place (see `view_changed()`). While loading, every frame is
+ * rendered, as rows are published.
  *
- * Computes and stores the combined MVP matrix.
+ * Clears the render image to a solid color and default the Z-buffer, and
+ * computes and stores the combined MVP matrix. Then draws the grid, or the
+ * tiles of maps drawn out of core (see `open_tiles()`): their lines are
+ * turned into screen-space segments, binned by bands of rows of the image,
+ * and the bands are drawn by the workers in parallel (see
+ * `raster_segments()`). A frame missing segments for lack of memory is
+ * drawn again on the next one, by forgetting its view.
  *
- * - For every second triangle, top and left edges are drawn.
- *
- * - For tringles in the last row or last column, edges as drawn for both
- * triangles to ensure the boundary lines are rendered.
- *
- * @param param Rendering context.
+ * @param ctx Rendering context.
+ * @return `true` if the frame was rendered, `false` if it was skipped.
  */
-void	render(void *param)
+bool	render(t_context *ctx)
 {
-	size_t		i;
-	t_vec3		*index;
-	t_context	*ctx;
-	t_vec2i		v_rc;
+	bool	loading;
+	bool	ready;
+	bool	ok;
 
-	ctx = param;
+	loading = !ctx->load.finished;
+	ready = update_model(ctx);
+	if (!view_changed(ctx) && !loading)
+		return (false);
 	clear_image(ctx, 0xFF000000);
-	ctx->m.m = model_matrix(ctx);
-	ctx->m.v = view_matrix(ctx->cam);
-	ctx->m.p = proj_ortho(ctx->cam);
-	if (ctx->cam.projection == PERSPECTIVE)
-		ctx->m.p = proj_persp(ctx->cam);
-	ctx->m.mvp = mat4_mul(mat4_mul(ctx->m.p, ctx->m.v), ctx->m.m);
-	v_rc = vec2i(ctx->rows_cols.x - 1, ctx->rows_cols.y - 1);
-	i = -1;
-	while (++i < ctx->tris->total)
-	{
-		if (i % 2 == 0 || (i / (2 * v_rc.y) == (size_t)v_rc.x - 1 && i % 2) || \
-((i / 2) % v_rc.y == (size_t)v_rc.y - 1 && i % 2))
-		{
-			index = vector_get(ctx->tris, i);
-			render_line(ctx, index->x, index->y);
-			render_line(ctx, index->y, index->z);
-		}
-	}
+	if (!ready)
+		return (true);
+	update_matrices(ctx);
+	split_bands(ctx);
+	if (ctx->tiles.enabled)
+		ok = render_tiles(ctx);
+	else
+		ok = render_mesh(ctx);
+	if (!ok)
+		ft_bzero(&ctx->view, sizeof(t_view));
+	return (true);
 }
 
 /**
- * Copies the vertices on a line to preserve the original ones.
- * Then the MVP matrix is applied to the copies, transforming them into
- * clip space.
+ * Draws the segments of a band of rows of the image, from every
+ * worker that binned segments, in the order they were emitted (see
+ * `bin_segments()`). The hierarchical Z-buffer of the band is then brought
+ * up to date for the next batch of segments (see `refresh_hiz()`).
  *
- * Liang-Barsky clipping method first clips the vertices in clip space. Then,
- * the vertices are transformed into screen space and Liang-Barsky is
- * applied in screen space to ensure only the vertices inside the screen
- * dimensions are drawn.
- *
- * @param ctx Rendering context containing vertices, render image, and color.
- * @param idx0 Index for vertex 0.
- * @param idx1 Index for vertex 1.
+ * @param ctx Rendering context.
+ * @param band Index of the band.
  */
-static inline void	render_line(t_context *ctx, int idx0, int idx1)
+void	raster_band(t_context *ctx, int band)
 {
-	t_vertex	v0;
-	t_vertex	v1;
+	t_worker	*w;
+	t_vec2i		rows;
+	uint32_t	i;
+	int			k;
 
-	v0 = *(t_vertex *)vector_get(ctx->verts, idx0);
-	v1 = *(t_vertex *)vector_get(ctx->verts, idx1);
-	v0.o_pos = v0.pos;
-	v1.o_pos = v1.pos;
-	v0.pos = mat4_mul_vec4(ctx->m.mvp, v0.pos);
-	v1.pos = mat4_mul_vec4(ctx->m.mvp, v1.pos);
-	if (!liang_barsky_clip(&v0, &v1))
-		return ;
-	project_to_screen(&v0, ctx);
-	project_to_screen(&v1, ctx);
-	if (!liang_barsky_screen(ctx, &v0, &v1))
-		return ;
-	ctx->color = v0.color;
-	draw_line(ctx, v0, v1);
+	rows.x = band * ctx->workers.band_rows;
+	rows.y = rows.x + ctx->workers.band_rows;
+	k = -1;
+	while (++k < ctx->workers.producers)
+	{
+		w = &ctx->workers.worker[k];
+		i = w->starts[band];
+		while (i < w->starts[band + 1])
+			draw_segment(ctx, &w->segs[w->bins[i++]], rows);
+	}
+	refresh_hiz(ctx, rows);
 }
 
 /**
- * Implements Bresenham's line algorithm with incremental error tracking
- * as best approximation to the ideal line.
- * Interpolates both color and depth (z) along the line.
- *
- * Draws the pixel if it passes depth test against previously drawn pixel
- * at the same location.
+ * Cuts the image into the bands drawn by the workers: bands of BAND_ROWS
+ * rows, enough to keep every worker busy, or a single band when there is a
+ * single worker, as it then owns the whole image. BAND_ROWS is a multiple
+ * of HZ_SIZE, so no tile of the hierarchical Z-buffer straddles two bands.
  *
- * @param ctx Rendering context containing colors and altitude range.
- * @param v0 Starting vertex (screen pos, color, depth)
- * @param v1 Ending vertex (screen pos, color, depth)
+ * @param ctx Rendering context.
  */
-static inline void	draw_line(
-						t_context *ctx, t_vertex v0, t_vertex v1)
+static inline void	split_bands(t_context *ctx)
 {
-	t_vec2i	d;
-	t_vec2i	s;
-	int		error;
-	t_vec2i	iterations;
-	t_vec3	t;
-
-	d = vec2i(abs(v1.s.x - v0.s.x), abs(v1.s.y - v0.s.y));
-	s = vec2i(1 + (-2 * (v0.s.x >= v1.s.x)), 1 + (-2 * (v0.s.y >= v1.s.y)));
-	error = d.x - d.y;
-	iterations = vec2i(0, ft_imax(d.x, d.y));
-	while (iterations.x <= iterations.y)
-	{
-		t.x = (float)iterations.x++ / iterations.y;
-		if (depth_test(ctx, v0, v1, t))
-			draw_pixel(ctx, v0, ctx->color);
-		move_pixel(&d, &s, &error, &v0);
-	}
+	ctx->workers.band_rows = BAND_ROWS;
+	if (ctx->workers.threads == 1)
+		ctx->workers.band_rows = ctx->img->height;
+	ctx->workers.bands = (ctx->img->height + ctx->workers.band_rows - 1) /
+		ctx->workers.band_rows;
 }
 
 /**
- * Advances the current pixel position along the line.
- * Uses the accumulated error term to determine a step in
- * x, y, or both directions.
+ * Works on copies of the transformed vertices of a line to preserve the
+ * ones shared with other lines (see `transform_vert()`).
+ *
+ * Lines with both vertices outside the same plane of the view frustum are
+ * rejected by their outcodes. Lines with a vertex outside of it are clipped
+ * with Liang-Barsky in clip space and transformed into screen space, lines
+ * inside of it already are. Then Liang-Barsky is applied in screen space to
+ * ensure only the vertices inside the screen dimensions are drawn.
+ *
+ * The line is not drawn yet, but stored as a segment of the worker.
  *
- * @param d Absolute difference in x and y between endpoints.
- * @param s Step direction for x and y (-1 or +1).
- * @param error Accumulated error term, updated when stepping.
- * @param v0 Current vertex, screen-space coordinates updated in-place.
+ * @param w Worker emitting the line.
+ * @param p0 Vertex 0 in clip space.
+ * @param p1 Vertex 1 in clip space.
  */
-static inline void	move_pixel(
-						t_vec2i *d, t_vec2i *s, int *error, t_vertex *v0)
+void	render_line(t_worker *w, t_post *p0, t_post *p1)
 {
-	t_vec2i	*delta;
-	t_vec2i	*slope;
-	t_vec2i	*screen;
-	int		e2;
+	t_vertex	v0;
+	t_vertex	v1;
 
-	delta = d;
-	slope = s;
-	screen = &(v0->s);
-	e2 = 2 * (*error);
-	if (e2 > -delta->y)
-	{
-		*error -= delta->y;
-		screen->x += slope->x;
-	}
-	if (e2 < delta->x)
+	if (p0->out & p1->out)
+		return ;
+	v0 = p0->v;
+	v1 = p1->v;
+	if (p0->out | p1->out)
 	{
-		*error += delta->x;
-		screen->y += slope->y;
+		if (!liang_barsky_clip(&v0, &v1))
+			return ;
+		project_to_screen(&v0, w->ctx);
+		project_to_screen(&v1, w->ctx);
 	}
+	if (!liang_barsky_screen(w->ctx, &v0, &v1))
+		return ;
+	emit_segment(w, &v0, &v1);
 }
 
 /**
- * Stores a pixel in the framebuffer if it's within the render image
- * boundaries. The framebuffer uses 32-bit ABGR colors.
+ * Stores the screen-space segment of a line with what `draw_segment()`
+ * steps along it. Lines of a single pixel are dropped, as they have no
+ * steps. The clipped vertices lie inside the image, which is checked once
+ * here, as the pixels are not. Lines hidden behind the ones drawn by the
+ * previous batches are dropped too (see `segment_hidden()`).
  *
- * @param ctx Rendering context containing render image and Z-buffer.
- * @param v0 Current vertex with interpolated screen-space coordinates (x, y).
- * @param c Pixel color (32-bit RGBA).
+ * @param w Worker emitting the line.
+ * @param v0 Vertex 0 in screen space.
+ * @param v1 Vertex 1 in screen space.
  */
-static inline void	draw_pixel(
-						t_context *ctx, t_vertex v0, uint32_t c)
+static inline void	emit_segment(t_worker *w, t_vertex *v0, t_vertex *v1)
 {
-	int			x;
-	int			y;
-	uint32_t	*pixels;
-	uint32_t	abgr_c;
+	t_segment	*seg;
 
-	x = v0.s.x;
-	y = v0.s.y;
-	pixels = (uint32_t *)ctx->img->pixels;
-	if (x >= 0 && x < (int)ctx->img->width && \
-y >= 0 && y < (int)ctx->img->height)
-	{
-		abgr_c = (c & 0xFF) << 24 | \
-(c & 0xFF00) << 8 | \
-(c & 0xFF0000) >> 8 | \
-(c & 0xFF000000) >> 24;
-		pixels[y * ctx->img->width + x] = abgr_c;
-	}
+	if ((v0->s.x == v1->s.x && v0->s.y == v1->s.y) || w->count == w->cap ||
+		(uint32_t)ft_imax(v0->s.x, v1->s.x) >= w->ctx->img->width ||
+		(uint32_t)ft_imax(v0->s.y, v1->s.y) >= w->ctx->img->height ||
+		ft_imin(ft_imin(v0->s.x, v1->s.x), ft_imin(v0->s.y, v1->s.y)) < 0)
+		return ;
+	seg = &w->segs[w->count];
+	seg->s0 = v0->s;
+	seg->s1 = v1->s;
+	segment_steps(w->ctx, seg, v0, v1);
+	if (!segment_hidden(w->ctx, seg))
+		++w->count;
 }
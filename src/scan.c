@@ -0,0 +1,107 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   scan.c                                             :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: myli-pen <myli-pen@student.hive.fi>        +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/17 22:49:09 by myli-pen          #+#    #+#             */
+/*   Updated: 2026/10/17 22:49:09 by myli-pen         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "fdf.h"
+
+static inline void	load_block(t_scan *scan, const char *ptr);
+
+/**
+ * Starts a structural scan over a range of the map.
+ *
+ * The scanner classifies SCAN_BLOCK bytes at a time into bitmasks of
+ * separators (spaces and newlines) and spaces, so finding the bounds of the
+ * next element is a shift and a bit scan instead of a byte loop.
+ *
+ * @param scan Scanner to be initialized.
+ * @param ptr Start of the range.
+ * @param end End of the range, never read past.
+ */
+void	scan_init(t_scan *scan, const char *ptr, const char *end)
+{
+	scan->end = end;
+	load_block(scan, ptr);
+}
+
+/**
+ * Finds the next separator, a space or a newline, at or after `ptr`.
+ *
+ * @param scan Scanner over the range containing `ptr`.
+ * @param ptr Position to scan from, at or after the previous one.
+ * @return Pointer to the separator, or the end of the range.
+ */
+const char	*scan_sep(t_scan *scan, const char *ptr)
+{
+	uint64_t	bits;
+
+	while (ptr < scan->end)
+	{
+		if (ptr < scan->block || ptr >= scan->block + SCAN_BLOCK)
+			load_block(scan, ptr);
+		bits = scan->seps >> (ptr - scan->block);
+		if (bits)
+			return (ptr + __builtin_ctzll(bits));
+		ptr = scan->block + SCAN_BLOCK;
+	}
+	return (scan->end);
+}
+
+/**
+ * Skips the run of spaces at `ptr`.
+ *
+ * @param scan Scanner over the range containing `ptr`.
+ * @param ptr Position to scan from, at or after the previous one.
+ * @return Pointer to the first byte that is not a space, or the end of the
+ * range.
+ */
+const char	*scan_skip(t_scan *scan, const char *ptr)
+{
+	uint64_t	bits;
+
+	while (ptr < scan->end)
+	{
+		if (ptr < scan->block || ptr >= scan->block + SCAN_BLOCK)
+			load_block(scan, ptr);
+		bits = ~scan->spaces >> (ptr - scan->block);
+		if (bits)
+			return (ptr + __builtin_ctzll(bits));
+		ptr = scan->block + SCAN_BLOCK;
+	}
+	return (scan->end);
+}
+
+/**
+ * Classifies the block starting at `ptr`. Full blocks go through the
+ * vectorized `scan_block()`. The last partial block of the range is
+ * classified byte by byte, with the bytes past the end marked as
+ * separators that are not spaces, so both scans stop exactly at the end.
+ *
+ * @param scan Scanner.
+ * @param ptr Start of the block.
+ */
+static inline void	load_block(t_scan *scan, const char *ptr)
+{
+	size_t	len;
+	size_t	i;
+
+	scan->block = ptr;
+	len = scan->end - ptr;
+	if (len >= SCAN_BLOCK)
+		return (scan_block(ptr, &scan->seps, &scan->spaces));
+	scan->seps = ~0ULL << len;
+	scan->spaces = 0;
+	i = -1;
+	while (++i < len)
+	{
+		scan->seps |= (uint64_t)(ptr[i] == ' ' || ptr[i] == '\n') << i;
+		scan->spaces |= (uint64_t)(ptr[i] == ' ') << i;
+	}
+}
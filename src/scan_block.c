@@ -0,0 +1,128 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   scan_block.c                                       :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: myli-pen <myli-pen@student.hive.fi>        +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/17 22:53:49 by myli-pen          #+#    #+#             */
+/*   Updated: 2026/10/17 22:53:49 by myli-pen         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "fdf.h"
+
+#if defined(__AVX2__)
+
+/**
+ * Classifies a block of SCAN_BLOCK bytes with AVX2, 32 bytes at a time.
+ * Bit `i` of each mask describes byte `i` of the block.
+ *
+ * @param ptr Block to be classified, at least SCAN_BLOCK bytes.
+ * @param seps Out mask of spaces and newlines.
+ * @param spaces Out mask of spaces.
+ */
+void	scan_block(const char *ptr, uint64_t *seps, uint64_t *spaces)
+{
+	__m256i		v;
+	uint64_t	sp;
+	uint64_t	nl;
+	int			i;
+
+	*seps = 0;
+	*spaces = 0;
+	i = -1;
+	while (++i < SCAN_BLOCK / 32)
+	{
+		v = _mm256_loadu_si256((const __m256i *)(ptr + i * 32));
+		sp = (uint32_t)_mm256_movemask_epi8(
+				_mm256_cmpeq_epi8(v, _mm256_set1_epi8(' ')));
+		nl = (uint32_t)_mm256_movemask_epi8(
+				_mm256_cmpeq_epi8(v, _mm256_set1_epi8('\n')));
+		*spaces |= sp << (i * 32);
+		*seps |= (sp | nl) << (i * 32);
+	}
+}
+
+#elif defined(__SSE2__)
+
+/**
+ * Classifies a block of SCAN_BLOCK bytes with SSE2, 16 bytes at a time.
+ * Bit `i` of each mask describes byte `i` of the block.
+ *
+ * @param ptr Block to be classified, at least SCAN_BLOCK bytes.
+ * @param seps Out mask of spaces and newlines.
+ * @param spaces Out mask of spaces.
+ */
+void	scan_block(const char *ptr, uint64_t *seps, uint64_t *spaces)
+{
+	__m128i		v;
+	uint64_t	sp;
+	uint64_t	nl;
+	int			i;
+
+	*seps = 0;
+	*spaces = 0;
+	i = -1;
+	while (++i < SCAN_BLOCK / 16)
+	{
+		v = _mm_loadu_si128((const __m128i *)(ptr + i * 16));
+		sp = (uint16_t)_mm_movemask_epi8(
+				_mm_cmpeq_epi8(v, _mm_set1_epi8(' ')));
+		nl = (uint16_t)_mm_movemask_epi8(
+				_mm_cmpeq_epi8(v, _mm_set1_epi8('\n')));
+		*spaces |= sp << (i * 16);
+		*seps |= (sp | nl) << (i * 16);
+	}
+}
+
+#else
+
+static inline uint64_t	byte_mask(uint64_t v, uint8_t c);
+
+/**
+ * Classifies a block of SCAN_BLOCK bytes within 64-bit words, 8 bytes at a
+ * time, for targets without SSE2. Assumes a little-endian target.
+ * Bit `i` of each mask describes byte `i` of the block.
+ *
+ * @param ptr Block to be classified, at least SCAN_BLOCK bytes.
+ * @param seps Out mask of spaces and newlines.
+ * @param spaces Out mask of spaces.
+ */
+void	scan_block(const char *ptr, uint64_t *seps, uint64_t *spaces)
+{
+	uint64_t	v;
+	uint64_t	sp;
+	uint64_t	nl;
+	int			i;
+
+	*seps = 0;
+	*spaces = 0;
+	i = -1;
+	while (++i < SCAN_BLOCK / 8)
+	{
+		ft_memcpy(&v, ptr + i * 8, sizeof(v));
+		sp = byte_mask(v, ' ');
+		nl = byte_mask(v, '\n');
+		*spaces |= sp << (i * 8);
+		*seps |= (sp | nl) << (i * 8);
+	}
+}
+
+/**
+ * Finds the bytes of a word equal to `c`, and gathers one bit per byte.
+ *
+ * @param v Word of 8 bytes.
+ * @param c Byte to be searched for.
+ * @return 8-bit mask, bit `i` set if byte `i` equals `c`.
+ */
+static inline uint64_t	byte_mask(uint64_t v, uint8_t c)
+{
+	const uint64_t	low = 0x7F7F7F7F7F7F7F7FULL;
+
+	v ^= 0x0101010101010101ULL * c;
+	v = ~(((v & low) + low) | v | low);
+	return ((v >> 7) * 0x0102040810204080ULL >> 56);
+}
+
+#endif
@@ -0,0 +1,146 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   span_lanes.c                                       :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: myli-pen <myli-pen@student.hive.fi>        +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/18 01:23:52 by myli-pen          #+#    #+#             */
+/*   Updated: 2026/10/18 01:23:52 by myli-pen         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "fdf.h"
+
+#if defined(__SSE2__)
+
+static inline __m128	lanes_test(float *z, __m128i *d);
+static inline void		lanes_color(t_segment *seg, __m128i t, __m128i mask,
+							__m128i *px);
+
+/**
+ * Draws the pixels of a horizontal run with SSE2, 4 at a time, with the
+ * same results as `draw_pixel()`: the depths and weights of the 4 pixels
+ * are stepped together, and the pixels failing the depth test keep their
+ * previous depth and color. Stops before the last pixels of the run that
+ * do not fill 4 lanes, leaving `sp` at the first of them.
+ *
+ * @param ctx Rendering context containing render image and Z-buffer.
+ * @param seg Segment in screen space.
+ * @param sp Run going right, updated in-place.
+ */
+void	draw_lanes(t_context *ctx, t_segment *seg, t_span *sp)
+{
+	__m128i	d[2];
+	__m128i	step;
+	__m128i	t;
+	__m128i	mask;
+
+	d[0] = _mm_set_epi64x(sp->depth + sp->ddepth, sp->depth);
+	step = _mm_set1_epi64x(2 * sp->ddepth);
+	d[1] = _mm_add_epi64(d[0], step);
+	step = _mm_add_epi64(step, step);
+	t = _mm_set_epi32(sp->t + 3 * sp->dt, sp->t + 2 * sp->dt,
+			sp->t + sp->dt, sp->t);
+	while (sp->n >= SPAN_LANES)
+	{
+		mask = _mm_castps_si128(lanes_test(ctx->z_buf + sp->index, d));
+		lanes_color(seg, t, mask,
+			(__m128i *)((uint32_t *)ctx->img->pixels + sp->index));
+		d[0] = _mm_add_epi64(d[0], step);
+		d[1] = _mm_add_epi64(d[1], step);
+		t = _mm_add_epi32(t, _mm_set1_epi32(SPAN_LANES * sp->dt));
+		sp->depth += SPAN_LANES * sp->ddepth;
+		sp->t += SPAN_LANES * sp->dt;
+		sp->index += SPAN_LANES;
+		sp->n -= SPAN_LANES;
+	}
+}
+
+/**
+ * Depth tests 4 pixels, and stores the depths of the ones passing it.
+ * The fixed-point depths are converted to doubles exactly, by adding them
+ * to the mantissa of FIX_DEPTH_MAGIC, then rounded once to floats, like
+ * the scalar conversion does.
+ *
+ * @param z Z-buffer at the first pixel.
+ * @param d Fixed-point depths of the pixels, 2 per vector.
+ * @return Mask of the pixels passing the depth test.
+ */
+static inline __m128	lanes_test(float *z, __m128i *d)
+{
+	__m128d	magic;
+	__m128	depth;
+	__m128	old;
+	__m128	mask;
+
+	magic = _mm_set1_pd(FIX_DEPTH_MAGIC);
+	depth = _mm_movelh_ps(
+			_mm_cvtpd_ps(_mm_sub_pd(_mm_castsi128_pd(
+						_mm_add_epi64(d[0], _mm_castpd_si128(magic))), magic)),
+			_mm_cvtpd_ps(_mm_sub_pd(_mm_castsi128_pd(
+						_mm_add_epi64(d[1], _mm_castpd_si128(magic))), magic)));
+	depth = _mm_mul_ps(depth, _mm_set1_ps((float)(1.0 / FIX_DEPTH_ONE)));
+	old = _mm_loadu_ps(z);
+	mask = _mm_cmpnge_ps(depth, old);
+	_mm_storeu_ps(z, _mm_or_ps(_mm_and_ps(mask, depth),
+			_mm_andnot_ps(mask, old)));
+	return (mask);
+}
+
+/**
+ * Blends the colors of 4 pixels from the two colors of the segment by
+ * their clamped weights, two channels of 16 bits at a time, like
+ * `draw_pixel()`, and stores the ones passing the depth test.
+ *
+ * @param seg Segment in screen space.
+ * @param t Fixed-point weights of the pixels.
+ * @param mask Mask of the pixels passing the depth test.
+ * @param px Framebuffer at the first pixel (32-bit ABGR).
+ */
+static inline void	lanes_color(t_segment *seg, __m128i t, __m128i mask,
+						__m128i *px)
+{
+	__m128i	w;
+	__m128i	over;
+	__m128i	rb;
+	__m128i	ag;
+
+	w = _mm_srai_epi32(t, FIX_COLOR - 8);
+	w = _mm_andnot_si128(_mm_cmplt_epi32(w, _mm_setzero_si128()), w);
+	over = _mm_cmpgt_epi32(w, _mm_set1_epi32(256));
+	w = _mm_or_si128(_mm_andnot_si128(over, w),
+			_mm_and_si128(over, _mm_set1_epi32(256)));
+	w = _mm_or_si128(w, _mm_slli_epi32(w, 16));
+	rb = _mm_add_epi16(_mm_mullo_epi16(_mm_set1_epi32(seg->color0 & 0xFF00FF),
+				_mm_sub_epi16(_mm_set1_epi16(256), w)),
+			_mm_mullo_epi16(_mm_set1_epi32(seg->color1 & 0xFF00FF), w));
+	ag = _mm_add_epi16(_mm_mullo_epi16(
+				_mm_set1_epi32(seg->color0 >> 8 & 0xFF00FF),
+				_mm_sub_epi16(_mm_set1_epi16(256), w)),
+			_mm_mullo_epi16(_mm_set1_epi32(seg->color1 >> 8 & 0xFF00FF), w));
+	rb = _mm_or_si128(_mm_and_si128(_mm_srli_epi32(rb, 8),
+				_mm_set1_epi32(0xFF00FF)),
+			_mm_and_si128(ag, _mm_set1_epi32((int)0xFF00FF00)));
+	_mm_storeu_si128(px, _mm_or_si128(_mm_and_si128(mask, rb),
+			_mm_andnot_si128(mask, _mm_loadu_si128(px))));
+}
+
+#else
+
+/**
+ * Leaves every pixel of a run to `draw_pixel()`, for targets without SSE2,
+ * where SPAN_LANES is 1.
+ *
+ * @param ctx Rendering context.
+ * @param seg Segment in screen space.
+ * @param sp Run going right.
+ */
+void	draw_lanes(t_context *ctx, t_segment *seg, t_span *sp)
+{
+	(void)ctx;
+	(void)seg;
+	(void)sp;
+}
+
+#endif
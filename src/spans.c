@@ -0,0 +1,173 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   spans.c                                            :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: myli-pen <myli-pen@student.hive.fi>        +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/18 01:23:15 by myli-pen          #+#    #+#             */
+/*   Updated: 2026/10/18 02:52:09 by myli-pen         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "fdf.h"
+
+static inline int	run_length(t_line *l);
+static inline void	advance_run(t_line *l, int r);
+static inline void	draw_span(t_context *ctx, t_segment *seg, t_line *l);
+
+/**
+ * Draws a line run by run, with the same pixels, depths and colors as the
+ * Bresenham walk of `draw_segment()` (run-slice): the pixels of a line
+ * along its major axis come in runs sharing their minor coordinate, and the
+ * length of each run is found from the error term in a single division,
+ * instead of a decision per pixel.
+ *
+ * Horizontal runs are contiguous in the image, and drawn SPAN_LANES pixels
+ * at a time (see `draw_lanes()`), vertical runs a pixel at a time.
+ * Like the walk, only the pixels in the band are drawn, and the runs stop
+ * once they have left it.
+ *
+ * @param ctx Rendering context containing render image and Z-buffer.
+ * @param seg Segment in screen space, clipped to the image.
+ * @param l Line walk at the first pixel of the line.
+ * @param band First and past the last row to draw.
+ */
+void	draw_runs(t_context *ctx, t_segment *seg, t_line *l, t_vec2i band)
+{
+	while (l->i <= l->n && (l->s.y < 0 || l->p.y < band.y) &&
+		(l->s.y > 0 || l->p.y >= band.x))
+	{
+		l->px.n = run_length(l);
+		if (l->d.y > l->d.x)
+			draw_column(ctx, seg, l, band);
+		else if (l->p.y >= band.x && l->p.y < band.y)
+			draw_span(ctx, seg, l);
+		advance_run(l, l->px.n);
+	}
+}
+
+/**
+ * Computes the length of the run starting at the current pixel of a line.
+ * Along x, the walk keeps stepping x only while `2 * error >= dx`, the
+ * error going down by dy with each pixel. Along y, it keeps stepping y only
+ * while `2 * error <= -dy`, the error going up by dx with each pixel.
+ *
+ * @param l Line walk at the first pixel of the run.
+ * @return Number of pixels of the run, up to the end of the line.
+ */
+static inline int	run_length(t_line *l)
+{
+	int	k;
+
+	k = l->n;
+	if (l->d.x >= l->d.y)
+	{
+		if (2 * l->error < l->d.x)
+			k = 0;
+		else if (l->d.y)
+			k = (2 * l->error - l->d.x) / (2 * l->d.y) + 1;
+	}
+	else if (2 * l->error > -l->d.y)
+		k = 0;
+	else if (l->d.x)
+		k = (-l->d.y - 2 * l->error) / (2 * l->d.x) + 1;
+	return (ft_imin(k + 1, l->n - l->i + 1));
+}
+
+/**
+ * Moves a line walk past a run of pixels, onto the first pixel of the next
+ * run, as `r` steps of `move_pixel()` would.
+ *
+ * @param l Line walk at the first pixel of the run, updated in-place.
+ * @param r Number of pixels of the run.
+ */
+static inline void	advance_run(t_line *l, int r)
+{
+	l->i += r;
+	l->px.depth += r * l->px.ddepth;
+	l->px.t += r * l->px.dt;
+	if (l->d.x >= l->d.y)
+	{
+		l->error += l->d.x - r * l->d.y;
+		l->p.x += r * l->s.x;
+		l->p.y += l->s.y;
+		l->px.index += r * l->s.x + l->stride;
+		return ;
+	}
+	l->error += r * l->d.x - l->d.y;
+	l->p.y += r * l->s.y;
+	l->p.x += l->s.x;
+	l->px.index += r * l->stride + l->s.x;
+}
+
+/**
+ * Moves a line walk from its first pixel onto its first pixel in a band of
+ * rows, as the steps of `move_pixel()` up to it would, but at once: after
+ * `i` pixels along its major axis, a line has stepped
+ * `(2 * i * minor + major - 1) / (2 * major)` pixels along the other one.
+ * Along x, the first pixel of the band is the first pixel of the walk to
+ * step onto its row.
+ *
+ * @param l Line walk at the first pixel of the line, updated in-place.
+ * @param band First and past the last row to draw.
+ */
+void	seek_band(t_line *l, t_vec2i band)
+{
+	t_vec2i	step;
+	int		i;
+
+	step.y = (band.x - l->p.y) * l->s.y;
+	if (l->s.y < 0)
+		step.y = (band.y - 1 - l->p.y) * l->s.y;
+	if (step.y <= 0)
+		return ;
+	step.x = (2 * step.y * l->d.x + l->d.y - 1) / (2 * l->d.y);
+	if (l->d.x >= l->d.y)
+		step.x = (2 * step.y * l->d.x - l->d.x + 2 * l->d.y) / (2 * l->d.y);
+	i = ft_imax(step.x, step.y);
+	l->i += i;
+	l->error += step.y * l->d.x - step.x * l->d.y;
+	l->p = vec2i(l->p.x + step.x * l->s.x, l->p.y + step.y * l->s.y);
+	l->px.index += step.x * l->s.x + step.y * l->stride;
+	l->px.depth += i * l->px.ddepth;
+	l->px.t += i * l->px.dt;
+}
+
+/**
+ * Draws a horizontal run of `l->px.n` pixels of a line. Runs going left are
+ * drawn from their last pixel, stepping backwards, as the pixels of a run
+ * never overlap. Runs hidden in the hierarchical Z-buffer are not drawn
+ * (see `span_visible()`). Full groups of SPAN_LANES pixels are drawn by
+ * `draw_lanes()`, the rest a pixel at a time.
+ *
+ * @param ctx Rendering context containing render image and Z-buffer.
+ * @param seg Segment in screen space.
+ * @param l Line walk at the first pixel of the run.
+ */
+static inline void	draw_span(t_context *ctx, t_segment *seg, t_line *l)
+{
+	t_span	sp;
+	t_vec2i	lo;
+
+	sp = l->px;
+	lo = vec2i(l->p.x - (l->s.x < 0) * (sp.n - 1), l->p.y);
+	if (!span_visible(ctx, lo, &sp))
+		return ;
+	if (l->s.x < 0)
+	{
+		sp.index -= sp.n - 1;
+		sp.depth += (sp.n - 1) * sp.ddepth;
+		sp.t += (sp.n - 1) * sp.dt;
+		sp.ddepth = -sp.ddepth;
+		sp.dt = -sp.dt;
+	}
+	draw_lanes(ctx, seg, &sp);
+	while (sp.n-- > 0)
+	{
+		draw_pixel(ctx, seg, &sp);
+		sp.index++;
+		sp.depth += sp.ddepth;
+		sp.t += sp.dt;
+	}
+}
@@ -0,0 +1,151 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   stream.c                                           :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: myli-pen <myli-pen@student.hive.fi>        +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/17 23:33:49 by myli-pen          #+#    #+#             */
+/*   Updated: 2026/10/17 23:53:29 by myli-pen         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "fdf.h"
+
+static inline ssize_t	read_more(t_stream *s, t_context *ctx);
+static inline bool		parse_rows(t_stream *s, t_context *ctx);
+static inline bool		grow_buf(t_stream *s);
+
+/**
+ * Checks if the map is streamed: the standard input, given as `-`, or a
+ * FIFO. A FIFO is opened without blocking, so the window opens before the
+ * program writing into it does.
+ *
+ * @param ctx Rendering context with the path of the map.
+ * @return `true` if the map is streamed, with `load.fd` set to the stream,
+ * or to -1 if the FIFO cannot be opened.
+ */
+bool	open_stream(t_context *ctx)
+{
+	struct stat	st;
+	bool		std_in;
+
+	std_in = !ft_strncmp(ctx->file, "-", 2);
+	ctx->load.stream = std_in ||
+		(stat(ctx->file, &st) == 0 && S_ISFIFO(st.st_mode));
+	ctx->load.fd = STDIN_FILENO;
+	if (ctx->load.stream && !std_in)
+		ctx->load.fd = open(ctx->file, O_RDONLY | O_NONBLOCK);
+	return (ctx->load.stream);
+}
+
+/**
+ * Parses a streamed map as it arrives. Runs on the loader thread.
+ *
+ * The total size is never known: complete lines are parsed as soon as they
+ * are read, and every row is published to the renderer right away. The
+ * first line sets the column count and the row storage is grown as rows
+ * keep coming (see `grow_rows()`). Only the line being read is buffered.
+ *
+ * @param ctx Rendering context with the stream opened by `open_stream()`.
+ * @return `true` on success, `false` on a malformed map, a read error, or a
+ * map larger than the memory budget.
+ */
+bool	stream_map(t_context *ctx)
+{
+	t_stream	s;
+
+	ft_bzero(&s, sizeof(t_stream));
+	s.chunk.ctx = ctx;
+	s.chunk.alt = vec2i(INT_MAX, INT_MIN);
+	s.chunk.ok = true;
+	while (s.chunk.ok && !s.eof)
+		s.chunk.ok = read_more(&s, ctx) >= 0 && parse_rows(&s, ctx);
+	free(s.buf);
+	return (s.chunk.ok && s.chunk.row >= 2);
+}
+
+/**
+ * Reads the next block of the stream into the line buffer, which grows
+ * when full. Waits for data with poll(), so a cancelled load is
+ * noticed even when the stream is idle.
+ *
+ * @param s Stream state.
+ * @param ctx Rendering context.
+ * @return Number of bytes read, 0 at the end of the stream, -1 on failure
+ * or cancel.
+ */
+static inline ssize_t	read_more(t_stream *s, t_context *ctx)
+{
+	struct pollfd	pfd;
+	ssize_t			n;
+
+	if (s->len == s->size && !grow_buf(s))
+		return (-1);
+	pfd = (struct pollfd){ctx->load.fd, POLLIN, 0};
+	while (!atomic_load(&ctx->load.cancel))
+	{
+		n = poll(&pfd, 1, STREAM_POLL);
+		if (n > 0)
+			n = read(ctx->load.fd, s->buf + s->len, s->size - s->len);
+		if (n < 0 && errno != EAGAIN && errno != EINTR)
+			return (-1);
+		if (n < 0 || !pfd.revents)
+			continue ;
+		s->len += n;
+		s->eof = n == 0;
+		return (n);
+	}
+	return (-1);
+}
+
+/**
+ * Parses the complete lines in the buffer, and the last line without a
+ * newline at the end of the stream. The incomplete line left is moved to
+ * the start of the buffer.
+ *
+ * @param s Stream state.
+ * @param ctx Rendering context.
+ * @return `true` on success, `false` on a malformed row or a row that does
+ * not fit.
+ */
+static inline bool	parse_rows(t_stream *s, t_context *ctx)
+{
+	const char	*end;
+
+	end = s->buf + s->len;
+	while (!s->eof && end > s->buf && end[-1] != '\n')
+		--end;
+	s->chunk.cur = (t_cursor){s->buf, end};
+	scan_init(&s->chunk.scan, s->buf, end);
+	while (s->chunk.cur.ptr < end)
+	{
+		if (!reserve_rows(ctx, &s->chunk) ||
+			parse_line(&s->chunk, s->chunk.row) != ctx->rows_cols.y)
+			return (false);
+		publish_row(ctx, s->chunk.row++, s->chunk.alt);
+	}
+	s->len = s->buf + s->len - end;
+	ft_memmove(s->buf, end, s->len);
+	return (true);
+}
+
+/**
+ * Grows the line buffer of the stream, keeping its content.
+ *
+ * @param s Stream state.
+ * @return `true` on success, `false` on allocation failure.
+ */
+static inline bool	grow_buf(t_stream *s)
+{
+	char	*buf;
+
+	buf = malloc(s->size * 2 + STREAM_BUF);
+	if (!buf)
+		return (false);
+	ft_memcpy(buf, s->buf, s->len);
+	free(s->buf);
+	s->buf = buf;
+	s->size = s->size * 2 + STREAM_BUF;
+	return (true);
+}
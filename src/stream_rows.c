@@ -0,0 +1,128 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   stream_rows.c                                      :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: myli-pen <myli-pen@student.hive.fi>        +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/17 23:34:27 by myli-pen          #+#    #+#             */
+/*   Updated: 2026/10/18 00:39:43 by myli-pen         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "fdf.h"
+
+static inline bool	first_rows(t_context *ctx, t_cursor line);
+
+/**
+ * Makes room for the next row of a streamed map on the loader thread.
+ * The first row sets the column count and allocates the first rows. Later,
+ * the main loop is asked to grow the rows between two frames, as it reads
+ * them (see `sync_stream()`), doubling them up to the memory budget.
+ *
+ * @param ctx Rendering context.
+ * @param chunk Stream cursor at the start of the row.
+ * @return `true` if the row fits, `false` otherwise.
+ */
+bool	reserve_rows(t_context *ctx, t_chunk *chunk)
+{
+	size_t	cap;
+	bool	ok;
+
+	if (chunk->row < ctx->load.cap)
+		return (true);
+	if (!ctx->load.cap)
+		return (first_rows(ctx, chunk->cur));
+	cap = ctx->opt.budget / ((size_t)ctx->rows_cols.y * VERT_SIZE);
+	cap = fmin(fmin(cap, INT_MAX), ctx->load.cap * 2.0);
+	if (cap <= (size_t)chunk->row)
+		return (false);
+	pthread_mutex_lock(&ctx->load.lock);
+	ctx->load.grow = cap;
+	while (ctx->load.grow && !atomic_load(&ctx->load.cancel))
+		pthread_cond_wait(&ctx->load.resized, &ctx->load.lock);
+	ok = chunk->row < ctx->load.cap;
+	pthread_mutex_unlock(&ctx->load.lock);
+	return (ok);
+}
+
+/**
+ * Grows the vertex store and the ready flags of a streamed map to `cap`
+ * rows, and moves the rows parsed so far into them.
+ *
+ * Streamed maps do not know their row count in advance, so unlike
+ * `alloc_rows()` the storage is allocated again each time it fills up.
+ * Called by the loader for the first rows, and afterwards only on the main
+ * loop while the loader waits, as the renderer reads the storage.
+ *
+ * @param ctx Rendering context with the column count set.
+ * @param cap New number of rows.
+ * @return `true` on success, `false` on allocation failure.
+ */
+bool	grow_rows(t_context *ctx, int cap)
+{
+	t_verts			verts;
+	atomic_uchar	*ready;
+
+	verts_alloc(&verts, cap, ctx->rows_cols.y);
+	ready = ft_calloc(cap, sizeof(atomic_uchar));
+	if (!verts.z || !ready || (ctx->load.cap && !verts_copy(&verts,
+				&ctx->verts, (size_t)ctx->load.cap * ctx->rows_cols.y)))
+	{
+		verts_free(&verts);
+		free(ready);
+		return (false);
+	}
+	if (ctx->load.cap)
+		ft_memcpy(ready, ctx->load.ready, ctx->load.cap);
+	memory_track(ctx, MEM_VERTS,
+		(ssize_t)verts.arena.used - (ssize_t)ctx->verts.arena.used);
+	verts_free(&ctx->verts);
+	free(ctx->load.ready);
+	ctx->verts = verts;
+	ctx->load.ready = ready;
+	ctx->load.cap = cap;
+	return (true);
+}
+
+/**
+ * Applies the progress of a streamed map on the main loop, with the loader
+ * lock held: grows the rows when the loader asks for it, and extends the
+ * rows drawn to the rows published. Once the stream has ended, the vertex
+ * store is cut down to the rows of the map.
+ *
+ * @param ctx Rendering context.
+ * @param state Load state.
+ */
+void	sync_stream(t_context *ctx, int state)
+{
+	if (ctx->load.grow)
+	{
+		grow_rows(ctx, ctx->load.grow);
+		ctx->load.grow = 0;
+		pthread_cond_signal(&ctx->load.resized);
+	}
+	ctx->rows_cols.x = ctx->load.rows;
+	if (state != LOAD_DONE)
+		return ;
+	ctx->verts.count = (size_t)ctx->rows_cols.x * ctx->rows_cols.y;
+}
+
+/**
+ * Sets the column count of a streamed map from its first line, allocates
+ * the first rows, and lets the renderer start drawing.
+ *
+ * @param ctx Rendering context.
+ * @param line Start of the stream.
+ * @return `true` on success, `false` on less than 2 columns or allocation
+ * failure.
+ */
+static inline bool	first_rows(t_context *ctx, t_cursor line)
+{
+	ctx->rows_cols.y = count_cols(&(t_file){(char *)line.ptr,
+			line.end - line.ptr});
+	if (ctx->rows_cols.y < 2 || !grow_rows(ctx, STREAM_ROWS))
+		return (false);
+	atomic_store(&ctx->load.state, LOAD_PARSING);
+	return (true);
+}
@@ -0,0 +1,151 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   tile_lru.c                                         :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: myli-pen <myli-pen@student.hive.fi>        +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/17 23:07:01 by myli-pen          #+#    #+#             */
+/*   Updated: 2026/10/18 03:57:54 by myli-pen         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "fdf.h"
+
+static inline void	unlink_tile(t_tiles *tiles, int tile);
+static inline void	evict_tile(t_tiles *tiles);
+static inline void	tile_alt(t_tiles *tiles, int tile);
+
+/**
+ * Sets up a map that does not fit the memory budget as a mesh to be drawn
+ * out of core, straight from the tiles of its cache.
+ *
+ * A valid cache is already mapped by `open_map()` and is taken over from
+ * the loader. Otherwise a new cache is created for the parser to write the
+ * tiles into. At most the budget worth of tiles is kept resident, the least
+ * recently drawn ones are released first.
+ *
+ * @param ctx Rendering context with `rows_cols` set.
+ * @return `true` on success, `false` on failure.
+ */
+bool	open_tiles(t_context *ctx)
+{
+	t_tiles	*tiles;
+	size_t	n;
+
+	tiles = &ctx->tiles;
+	init_tiles(tiles, ctx->rows_cols, NULL);
+	n = (size_t)tiles->count.x * tiles->count.y;
+	tiles->alt = malloc(sizeof(t_vec2i) * n);
+	tiles->prev = malloc(sizeof(int) * n);
+	tiles->next = malloc(sizeof(int) * n);
+	tiles->flags = ft_calloc(n, sizeof(uint8_t));
+	tiles->head = -1;
+	tiles->tail = -1;
+	tiles->max_resident = ft_imax(1, ctx->opt.budget / TILE_BYTES);
+	if (!tiles->alt || !tiles->prev || !tiles->next || !tiles->flags)
+		return (false);
+	if (ctx->load.from_cache)
+	{
+		tiles->map = ctx->load.file;
+		ctx->load.file = (t_file){NULL, 0};
+	}
+	else if (!create_cache(ctx, &tiles->map, tiles_size(ctx->rows_cols)))
+		return (false);
+	tiles->data = tiles->map.data + TILE_DATA;
+	return (true);
+}
+
+/**
+ * Marks a tile as the most recently drawn one. A tile that is not resident
+ * yet is added, releasing the least recently drawn tiles to stay within the
+ * budget. Its exact altitude range is gathered the first time it is drawn.
+ *
+ * @param tiles Tiles of the grid.
+ * @param tile Index of the tile about to be drawn.
+ */
+void	tile_acquire(t_tiles *tiles, int tile)
+{
+	if (tiles->flags[tile] & TILE_RESIDENT)
+		unlink_tile(tiles, tile);
+	else
+	{
+		while (tiles->resident >= tiles->max_resident)
+			evict_tile(tiles);
+		tiles->flags[tile] |= TILE_RESIDENT;
+		++tiles->resident;
+	}
+	tiles->prev[tile] = -1;
+	tiles->next[tile] = tiles->head;
+	if (tiles->head != -1)
+		tiles->prev[tiles->head] = tile;
+	tiles->head = tile;
+	if (tiles->tail == -1)
+		tiles->tail = tile;
+	if (!(tiles->flags[tile] & TILE_KNOWN))
+		tile_alt(tiles, tile);
+}
+
+/**
+ * Removes a tile from the recently drawn list.
+ *
+ * @param tiles Tiles of the grid.
+ * @param tile Index of a resident tile.
+ */
+static inline void	unlink_tile(t_tiles *tiles, int tile)
+{
+	if (tiles->prev[tile] != -1)
+		tiles->next[tiles->prev[tile]] = tiles->next[tile];
+	else
+		tiles->head = tiles->next[tile];
+	if (tiles->next[tile] != -1)
+		tiles->prev[tiles->next[tile]] = tiles->prev[tile];
+	else
+		tiles->tail = tiles->prev[tile];
+}
+
+/**
+ * Releases the pages of the least recently drawn tile.
+ *
+ * @param tiles Tiles of the grid with at least one resident tile.
+ */
+static inline void	evict_tile(t_tiles *tiles)
+{
+	int	tile;
+
+	tile = tiles->tail;
+	unlink_tile(tiles, tile);
+	tiles->flags[tile] &= ~TILE_RESIDENT;
+	--tiles->resident;
+	drop_pages(tiles->data + (size_t)tile * TILE_BYTES, TILE_BYTES);
+}
+
+/**
+ * Gathers the altitude range of a tile, which makes its bounding box, and
+ * so the culling of the tile, exact.
+ *
+ * @param tiles Tiles of the grid.
+ * @param tile Index of a completely loaded tile.
+ */
+static inline void	tile_alt(t_tiles *tiles, int tile)
+{
+	int32_t	*heights;
+	t_vec2i	size;
+	t_vec2i	alt;
+	int		i;
+
+	heights = (int32_t *)(tiles->data + (size_t)tile * TILE_BYTES);
+	size.x = ft_imin(TILE_SIZE,
+			tiles->grid.y - tile % tiles->count.y * (TILE_SIZE - 1));
+	size.y = ft_imin(TILE_SIZE,
+			tiles->grid.x - tile / tiles->count.y * (TILE_SIZE - 1));
+	alt = vec2i(INT_MAX, INT_MIN);
+	i = -1;
+	while (++i < size.x * size.y)
+	{
+		alt.x = ft_imin(alt.x, heights[i / size.x * TILE_SIZE + i % size.x]);
+		alt.y = ft_imax(alt.y, heights[i / size.x * TILE_SIZE + i % size.x]);
+	}
+	tiles->alt[tile] = alt;
+	tiles->flags[tile] |= TILE_KNOWN;
+}
@@ -0,0 +1,185 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   tile_render.c                                      :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: myli-pen <myli-pen@student.hive.fi>        +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/17 23:07:17 by myli-pen          #+#    #+#             */
+/*   Updated: 2026/10/18 04:04:16 by myli-pen         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "fdf.h"
+
+static inline void	tile_area(t_tiles *tiles, int tile,
+						t_vec2i *origin, t_vec2i *end);
+static inline bool	tile_ready(t_context *ctx, int tile);
+static inline bool	tile_visible(t_context *ctx, int tile);
+static inline void	draw_tile(t_context *ctx, int tile);
+
+/**
+ * Renders the wireframe grid tile by tile from the tiled cache, when the map
+ * is drawn out of core (see `open_tiles()`).
+ *
+ * Tiles whose rows are still being loaded, and tiles whose bounding box lies
+ * outside of the view frustum, are skipped without touching their pages.
+ * The tiles are drawn front to back (see `update_matrices()`).
+ * The pages made resident or released are accounted as MEM_TILES.
+ *
+ * The tiles are turned into segments on the main loop, as the resident
+ * tiles are tracked there, and the segments are drawn by the workers in
+ * batches of SEG_BATCH (see `raster_segments()`).
+ *
+ * @param ctx Rendering context with the MVP matrix of the frame.
+ * @return `true` if the tiles were drawn whole, `false` on allocation
+ * failure.
+ */
+bool	render_tiles(t_context *ctx)
+{
+	size_t		resident;
+	t_vec2i		n;
+	bool		ok;
+	int			tile;
+	int			i;
+
+	ok = worker_scratch(ctx->workers.worker, SEG_BATCH);
+	resident = ctx->tiles.resident;
+	n = ctx->tiles.count;
+	i = -1;
+	while (ok && ++i < n.x * n.y)
+	{
+		tile = i + (ctx->m.order.x < 0) * (n.y - 1 - 2 * (i % n.y)) +
+			(ctx->m.order.y < 0) * n.y * (n.x - 1 - 2 * (i / n.y));
+		if (!tile_ready(ctx, tile) || !tile_visible(ctx, tile))
+			continue ;
+		tile_acquire(&ctx->tiles, tile);
+		draw_tile(ctx, tile);
+		if (ctx->workers.worker->count + 2 * TILE_SIZE * TILE_SIZE >
+			ctx->workers.worker->cap)
+			ok = flush_worker(ctx->workers.worker);
+	}
+	memory_track(ctx, MEM_TILES,
+		((ssize_t)ctx->tiles.resident - (ssize_t)resident) * TILE_BYTES);
+	return (ok && flush_worker(ctx->workers.worker));
+}
+
+/**
+ * Computes the grid positions spanned by a tile.
+ *
+ * @param tiles Tiles of the grid.
+ * @param tile Index of the tile.
+ * @param origin Out column (x) and row (y) of the first vertex.
+ * @param end Out column (x) and row (y) past the last vertex.
+ */
+static inline void	tile_area(t_tiles *tiles, int tile,
+						t_vec2i *origin, t_vec2i *end)
+{
+	origin->x = tile % tiles->count.y * (TILE_SIZE - 1);
+	origin->y = tile / tiles->count.y * (TILE_SIZE - 1);
+	end->x = ft_imin(origin->x + TILE_SIZE, tiles->grid.y);
+	end->y = ft_imin(origin->y + TILE_SIZE, tiles->grid.x);
+}
+
+/**
+ * Checks if every row of a tile has been published by the loader.
+ *
+ * @param ctx Rendering context.
+ * @param tile Index of the tile.
+ * @return `true` if the tile can be drawn.
+ */
+static inline bool	tile_ready(t_context *ctx, int tile)
+{
+	t_vec2i	origin;
+	t_vec2i	end;
+	int		row;
+
+	if (ctx->load.finished)
+		return (true);
+	tile_area(&ctx->tiles, tile, &origin, &end);
+	row = origin.y - 1;
+	while (++row < end.y)
+	{
+		if (!row_ready(ctx, row))
+			return (false);
+	}
+	return (true);
+}
+
+/**
+ * Tests the bounding box of a tile against the view frustum in clip space.
+ * The tile is culled if all eight corners lie outside of the same plane.
+ * Until the tile has been drawn once, the altitude range of the whole model
+ * is used for its box.
+ *
+ * @param ctx Rendering context with the MVP matrix of the frame.
+ * @param tile Index of the tile.
+ * @return `true` if the tile may be visible.
+ */
+static inline bool	tile_visible(t_context *ctx, int tile)
+{
+	t_vec3	box[2];
+	t_vec2i	area[2];
+	t_vec4	c;
+	int		out;
+	int		k;
+
+	tile_area(&ctx->tiles, tile, &area[0], &area[1]);
+	box[0] = vec3(area[0].x, -area[0].y, 0.0f);
+	box[1] = vec3(area[1].x - 1, 1 - area[1].y, 0.0f);
+	box[0].z = ctx->o_center.z - ctx->o_bounds.z * 0.5f;
+	box[1].z = ctx->o_center.z + ctx->o_bounds.z * 0.5f;
+	if (ctx->tiles.flags[tile] & TILE_KNOWN)
+		box[0].z = ctx->tiles.alt[tile].x;
+	if (ctx->tiles.flags[tile] & TILE_KNOWN)
+		box[1].z = ctx->tiles.alt[tile].y;
+	out = 0x3F;
+	k = -1;
+	while (++k < 8)
+	{
+		c = mat4_mul_vec4(ctx->m.mvp, vec4(box[k & 1].x,
+					box[(k >> 1) & 1].y, box[k >> 2].z, 1.0f));
+		out &= (c.x < -c.w) | (c.x > c.w) << 1 | (c.y < -c.w) << 2 |
+			(c.y > c.w) << 3 | (c.z < -c.w) << 4 | (c.z > c.w) << 5;
+	}
+	return (out == 0);
+}
+
+/**
+ * Draws the grid lines of a tile. Lines on the last row and column of the
+ * tile belong to the next tile, unless they are on the border of the grid,
+ * so shared lines are drawn once. Each line is drawn in the same direction
+ * as by `render_mesh()`, giving the same pixels. The vertices of the tile
+ * are transformed once into the post-transform buffer first.
+ *
+ * @param ctx Rendering context.
+ * @param tile Index of the tile.
+ */
+static inline void	draw_tile(t_context *ctx, int tile)
+{
+	t_vec2i	o;
+	t_vec2i	end;
+	t_vec2i	p;
+	int		w;
+	int		i;
+
+	tile_area(&ctx->tiles, tile, &o, &end);
+	if (!transform_tile(ctx, tile, o, end))
+		return ;
+	w = end.x - o.x;
+	i = -1;
+	while (++i < w * (end.y - o.y))
+	{
+		p = vec2i(o.x + i % w, o.y + i / w);
+		if (p.x + 1 < end.x &&
+			(p.y + 1 < end.y || p.y == ctx->rows_cols.x - 1))
+			render_line(ctx->workers.worker,
+				&ctx->post[i + (p.y + 1 < end.y)],
+				&ctx->post[i + (p.y + 1 == end.y)]);
+		if (p.y + 1 < end.y &&
+			(p.x + 1 < end.x || p.x == ctx->rows_cols.y - 1))
+			render_line(ctx->workers.worker,
+				&ctx->post[i + w * (p.x + 1 == end.x)],
+				&ctx->post[i + w * (p.x + 1 < end.x)]);
+	}
+}
@@ -0,0 +1,126 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   tiles.c                                            :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: myli-pen <myli-pen@student.hive.fi>        +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/17 23:06:42 by myli-pen          #+#    #+#             */
+/*   Updated: 2026/10/17 23:06:42 by myli-pen         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "fdf.h"
+
+/**
+ * Sets up the tile addressing of a grid. The grid is cut into tiles of
+ * TILE_SIZE x TILE_SIZE vertices that overlap their neighbours by one row
+ * and one column, so every tile holds all the vertices of its quads.
+ *
+ * Each tile stores the heights followed by the colors of its vertices, in
+ * TILE_BYTES. The tiles follow each other in row-major order from `data`.
+ *
+ * @param tiles Tiles to set up.
+ * @param grid Number of vertex rows (x) and columns (y).
+ * @param data Start of the first tile, may be NULL to only size the grid.
+ */
+void	init_tiles(t_tiles *tiles, t_vec2i grid, char *data)
+{
+	tiles->grid = grid;
+	tiles->count.x = ft_imax(1, (grid.x - 2) / (TILE_SIZE - 1) + 1);
+	tiles->count.y = ft_imax(1, (grid.y - 2) / (TILE_SIZE - 1) + 1);
+	tiles->data = data;
+}
+
+/**
+ * Returns the size of the tiled cache of a grid: the header page followed
+ * by the tiles.
+ *
+ * @param grid Number of vertex rows (x) and columns (y).
+ * @return Size in bytes.
+ */
+size_t	tiles_size(t_vec2i grid)
+{
+	t_tiles	tiles;
+
+	init_tiles(&tiles, grid, NULL);
+	return (TILE_DATA + (size_t)tiles.count.x * tiles.count.y * TILE_BYTES);
+}
+
+/**
+ * Returns the tile that owns the quads right and below a grid position.
+ * Positions on the last row or column belong to the last tile.
+ *
+ * @param tiles Tiles of the grid.
+ * @param pos Column (x) and row (y) of the vertex.
+ * @return Index of the tile.
+ */
+int	tile_index(t_tiles *tiles, t_vec2i pos)
+{
+	int	row;
+	int	col;
+
+	row = ft_imin(pos.y / (TILE_SIZE - 1), tiles->count.x - 1);
+	col = ft_imin(pos.x / (TILE_SIZE - 1), tiles->count.y - 1);
+	return (row * tiles->count.y + col);
+}
+
+/**
+ * Stores the height and color of a vertex in every tile that holds it,
+ * which is up to four tiles for a vertex on a tile corner.
+ *
+ * @param tiles Tiles of the grid, mapped writable.
+ * @param pos Column (x) and row (y) of the vertex.
+ * @param z Height of the vertex.
+ * @param color Vertex color (32-bit RGBA).
+ */
+void	tile_put(t_tiles *tiles, t_vec2i pos, int z, uint32_t color)
+{
+	int32_t	*heights;
+	t_vec2i	t;
+	t_vec2i	last;
+	int		first;
+	int		i;
+
+	t.x = (pos.y - 1) / (TILE_SIZE - 1) - 1;
+	first = (pos.x - 1) / (TILE_SIZE - 1);
+	last.x = ft_imin(pos.y / (TILE_SIZE - 1), tiles->count.x - 1);
+	last.y = ft_imin(pos.x / (TILE_SIZE - 1), tiles->count.y - 1);
+	while (++t.x <= last.x)
+	{
+		t.y = first - 1;
+		while (++t.y <= last.y)
+		{
+			heights = (int32_t *)(tiles->data +
+					(size_t)(t.x * tiles->count.y + t.y) * TILE_BYTES);
+			i = (pos.y - t.x * (TILE_SIZE - 1)) * TILE_SIZE +
+				pos.x - t.y * (TILE_SIZE - 1);
+			heights[i] = z;
+			((uint32_t *)heights)[TILE_SIZE * TILE_SIZE + i] = color;
+		}
+	}
+}
+
+/**
+ * Builds the vertex of a grid position from a tile that holds it.
+ *
+ * @param tiles Tiles of the grid.
+ * @param tile Index of a tile holding the position.
+ * @param pos Column (x) and row (y) of the vertex.
+ * @return Vertex with its object-space position and color.
+ */
+t_vertex	tile_vert(t_tiles *tiles, int tile, t_vec2i pos)
+{
+	int32_t		*heights;
+	t_vertex	v;
+	int			i;
+
+	heights = (int32_t *)(tiles->data + (size_t)tile * TILE_BYTES);
+	i = (pos.y - tile / tiles->count.y * (TILE_SIZE - 1)) * TILE_SIZE +
+		pos.x - tile % tiles->count.y * (TILE_SIZE - 1);
+	v.pos = vec4(pos.x, -(float)pos.y, heights[i], 1.0f);
+	v.color = ((uint32_t *)heights)[TILE_SIZE * TILE_SIZE + i];
+	v.s = vec2i(0, 0);
+	v.depth = 0.0f;
+	return (v);
+}
@@ -0,0 +1,126 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   tokens.c                                           :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: myli-pen <myli-pen@student.hive.fi>        +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/17 22:26:26 by myli-pen          #+#    #+#             */
+/*   Updated: 2026/10/17 22:56:25 by myli-pen         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "fdf.h"
+
+static inline bool	is_space(char c);
+static inline int	hex_value(char c, bool *bad);
+
+/**
+ * Finds the next comma separated word inside an element, without copying.
+ *
+ * Empty words are skipped, matching the behaviour of `ft_split(elem, ',')`.
+ * The element cursor is advanced past the returned word.
+ *
+ * @param elem Cursor over the remaining characters of the element.
+ * @param word Out cursor spanning the found word.
+ * @return `true` if a word was found, `false` if the element is exhausted.
+ */
+bool	next_word(t_cursor *elem, t_cursor *word)
+{
+	while (elem->ptr < elem->end && *elem->ptr == ',')
+		++elem->ptr;
+	word->ptr = elem->ptr;
+	while (elem->ptr < elem->end && *elem->ptr != ',')
+		++elem->ptr;
+	word->end = elem->ptr;
+	return (word->ptr < word->end);
+}
+
+/**
+ * Converts the initial portion of a word to an integer, like `ft_atoi()`,
+ * but never reads past the end of the word.
+ *
+ * @param word Cursor spanning the word.
+ * @return Integer value of the word.
+ */
+int	parse_int(t_cursor word)
+{
+	int	sign;
+	int	number;
+
+	while (word.ptr < word.end && is_space(*word.ptr))
+		++word.ptr;
+	sign = 1;
+	if (word.ptr < word.end && (*word.ptr == '-' || *word.ptr == '+'))
+		if (*word.ptr++ == '-')
+			sign = -1;
+	number = 0;
+	while (word.ptr < word.end && ft_isdigit(*word.ptr))
+		number = number * 10 + (*word.ptr++ - '0');
+	return (sign * number);
+}
+
+/**
+ * Converts the digits of a case-insensitive hex color (without the `0x`
+ * prefix) to a 32-bit RGBA value directly from the mapped file.
+ *
+ * Colors shorter than 8 digits are right-padded with zeros, so `FF0000`
+ * becomes `FF000000`. A zero alpha channel is made opaque.
+ * The digits are decoded without branching, and checked once at the end.
+ *
+ * @param word Cursor spanning the hex digits.
+ * @return 32-bit RGBA color, or ERROR_COLOR on invalid input.
+ */
+uint32_t	parse_hex(t_cursor word)
+{
+	uint32_t	color;
+	size_t		pad;
+	bool		bad;
+
+	if (word.end - word.ptr < 2 || word.end - word.ptr > 8)
+		return (ERROR_COLOR);
+	pad = 8 - (word.end - word.ptr);
+	while (word.ptr < word.end && is_space(*word.ptr))
+		++word.ptr;
+	if (word.ptr < word.end && *word.ptr == '+')
+		++word.ptr;
+	color = 0;
+	bad = false;
+	while (word.ptr < word.end)
+		color = color << 4 | hex_value(*word.ptr++, &bad);
+	if (bad)
+		return (ERROR_COLOR);
+	color <<= pad * 4;
+	if ((color & 0xFF) == 0)
+		color |= 0xFF;
+	return (color);
+}
+
+/**
+ * Checks if `c` is a whitespace character.
+ *
+ * @param c Character to be checked for.
+ * @return `true` if whitespace, else `false`.
+ */
+static inline bool	is_space(char c)
+{
+	return (c == ' ' || (c >= '\t' && c <= '\r'));
+}
+
+/**
+ * Returns the value of a case-insensitive hex digit without branching.
+ * Letters have bit 6 set, which adds the 9 that maps 'a' (or 'A') to 10.
+ *
+ * @param c Character to be converted.
+ * @param bad Set to `true` if `c` is not a hex digit, left as is otherwise.
+ * @return Value [0 - 15], meaningless if `c` is not a hex digit.
+ */
+static inline int	hex_value(char c, bool *bad)
+{
+	unsigned char	lower;
+
+	lower = c | 0x20;
+	*bad |= !((unsigned char)(c - '0') < 10 ||
+			(unsigned char)(lower - 'a') < 6);
+	return ((c & 0xF) + 9 * ((c >> 6) & 1));
+}
@@ -0,0 +1,145 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   transform.c                                        :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: myli-pen <myli-pen@student.hive.fi>        +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/18 00:04:05 by myli-pen          #+#    #+#             */
+/*   Updated: 2026/10/18 04:06:02 by myli-pen         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "fdf.h"
+
+static inline uint8_t	outcode(t_vec4 pos);
+
+/**
+ * Returns the post-transform buffer of the frame, bump allocated from the
+ * frame scratch arena. The arena is reset on every call, as only one buffer
+ * is live at a time, and only reserved again when it is too small. Only
+ * used on the main loop.
+ *
+ * @param ctx Rendering context.
+ * @param n Number of vertices.
+ * @return The buffer, or NULL on allocation failure.
+ */
+t_post	*post_buffer(t_context *ctx, size_t n)
+{
+	ft_arena_reset(&ctx->frame);
+	ctx->post = ft_arena_alloc(&ctx->frame, n * sizeof(t_post), VERT_ALIGN);
+	if (ctx->post)
+		return (ctx->post);
+	memory_track(ctx, MEM_FRAME, -(ssize_t)ctx->frame.size);
+	ft_arena_free(&ctx->frame);
+	if (ft_arena_init(&ctx->frame, n * sizeof(t_post)))
+	{
+		memory_track(ctx, MEM_FRAME, ctx->frame.size);
+		ctx->post = ft_arena_alloc(&ctx->frame, n * sizeof(t_post),
+				VERT_ALIGN);
+	}
+	return (ctx->post);
+}
+
+/**
+ * Transforms a vertex into clip space once for every edge sharing it.
+ * Stores its clip outcode, and its screen position and depth if it lies
+ * inside the view frustum, so edges between such vertices need neither
+ * clipping nor projecting again.
+ *
+ * The model is a regular grid, so instead of multiplying by the MVP matrix,
+ * the position is found from the clip-space position of its row and the
+ * deltas of a column and a unit of height (see `update_matrices()`):
+ * `base + col * dx + height * dz`, with no dependency between the vertices
+ * of a row, which `transform_lanes()` transforms BATCH_LANES at a time.
+ *
+ * @param ctx Rendering context with the grid deltas of the frame.
+ * @param base Clip-space position of column 0 at height 0 of the row.
+ * @param v Vertex in object space.
+ * @param post Out transformed vertex.
+ */
+void	transform_vert(t_context *ctx, t_vec4 base, t_vertex v, t_post *post)
+{
+	post->v = v;
+	post->v.o_pos = v.pos;
+	post->v.pos.x = base.x + v.pos.x * ctx->m.dx.x + v.pos.z * ctx->m.dz.x;
+	post->v.pos.y = base.y + v.pos.x * ctx->m.dx.y + v.pos.z * ctx->m.dz.y;
+	post->v.pos.z = base.z + v.pos.x * ctx->m.dx.z + v.pos.z * ctx->m.dz.z;
+	post->v.pos.w = base.w + v.pos.x * ctx->m.dx.w + v.pos.z * ctx->m.dz.w;
+	post->out = outcode(post->v.pos);
+	if (!post->out)
+		project_to_screen(&post->v, ctx);
+}
+
+/**
+ * Transforms a row of vertices of the vertex store, loaded in batches of
+ * BATCH_SIZE vertices for `transform_batch()`.
+ *
+ * @param ctx Rendering context.
+ * @param row Row index.
+ * @param out Out transformed vertices, one per column.
+ */
+void	transform_row(t_context *ctx, int row, t_post *out)
+{
+	t_batch	b;
+	int		col;
+
+	col = 0;
+	while (col < ctx->rows_cols.y)
+	{
+		load_batch(ctx, vec2i(col, row), &b);
+		transform_batch(ctx, &b, out + col);
+		col += b.n;
+	}
+}
+
+/**
+ * Transforms the vertices of a tile row by row into the post-transform
+ * buffer, a batch per row.
+ *
+ * @param ctx Rendering context.
+ * @param tile Index of the tile.
+ * @param origin Column (x) and row (y) of the first vertex.
+ * @param end Column (x) and row (y) past the last vertex.
+ * @return `true` on success, `false` on allocation failure, the tile is
+ * then missing from the batch, which `raster_segments()` reports.
+ */
+bool	transform_tile(t_context *ctx, int tile, t_vec2i origin, t_vec2i end)
+{
+	t_batch	b;
+	int		row;
+	int		i;
+
+	if (!post_buffer(ctx, TILE_SIZE * TILE_SIZE))
+	{
+		atomic_store(&ctx->workers.dropped, true);
+		return (false);
+	}
+	b.n = end.x - origin.x;
+	i = 0;
+	row = origin.y - 1;
+	while (++row < end.y)
+	{
+		load_tile_batch(ctx, tile, vec2i(origin.x, row), &b);
+		transform_batch(ctx, &b, &ctx->post[i]);
+		i += b.n;
+	}
+	return (true);
+}
+
+/**
+ * Computes the clip outcode of a position, one bit per plane of the view
+ * frustum (-w <= x,y,z <= w) it lies outside of.
+ *
+ * @param pos Position in clip space.
+ * @return Outcode, 0 inside the frustum.
+ */
+static inline uint8_t	outcode(t_vec4 pos)
+{
+	return ((pos.x + pos.w < 0.0f) * CLIP_LEFT |
+		(pos.w - pos.x < 0.0f) * CLIP_RIGHT |
+		(pos.y + pos.w < 0.0f) * CLIP_BOTTOM |
+		(pos.w - pos.y < 0.0f) * CLIP_TOP |
+		(pos.z + pos.w < 0.0f) * CLIP_NEAR |
+		(pos.w - pos.z < 0.0f) * CLIP_FAR);
+}
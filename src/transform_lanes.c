@@ -0,0 +1,197 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   transform_lanes.c                                  :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: myli-pen <myli-pen@student.hive.fi>        +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/18 01:05:01 by myli-pen          #+#    #+#             */
+/*   Updated: 2026/10/18 01:05:01 by myli-pen         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "fdf.h"
+
+#if defined(__AVX2__)
+
+static inline void	screen_lanes(t_context *ctx, __m256 *c, t_lanes *l);
+
+/**
+ * Transforms BATCH_LANES vertices of a batch into clip space with AVX2,
+ * 8 at a time, like `transform_vert()` does one at a time and with the
+ * same operations in the same order, so the results are identical.
+ * Bit `k` of each mask of `l->planes` is set if lane `k` lies outside the
+ * plane of the view frustum of the same index (see `outcode()`).
+ *
+ * Components of the vectors are indexed, as a t_vec4 is 4 packed floats.
+ *
+ * @param ctx Rendering context with the grid deltas of the frame.
+ * @param b Batch of vertices.
+ * @param i Index of the vertex of lane 0.
+ * @param l Out transformed lanes.
+ */
+void	transform_lanes(t_context *ctx, const t_batch *b, int i, t_lanes *l)
+{
+	__m256	xz[2];
+	__m256	c[4];
+	int		k;
+
+	xz[0] = _mm256_loadu_ps(b->x + i);
+	xz[1] = _mm256_loadu_ps(b->z + i);
+	k = -1;
+	while (++k < 4)
+	{
+		c[k] = _mm256_add_ps(_mm256_add_ps(_mm256_set1_ps((&b->base.x)[k]),
+					_mm256_mul_ps(xz[0], _mm256_set1_ps((&ctx->m.dx.x)[k]))),
+				_mm256_mul_ps(xz[1], _mm256_set1_ps((&ctx->m.dz.x)[k])));
+		_mm256_storeu_ps(l->clip[k], c[k]);
+	}
+	k = -1;
+	while (++k < 3)
+	{
+		l->planes[2 * k] = _mm256_movemask_ps(_mm256_cmp_ps(_mm256_add_ps(
+						c[k], c[3]), _mm256_setzero_ps(), _CMP_LT_OQ));
+		l->planes[2 * k + 1] = _mm256_movemask_ps(_mm256_cmp_ps(_mm256_sub_ps(
+						c[3], c[k]), _mm256_setzero_ps(), _CMP_LT_OQ));
+	}
+	screen_lanes(ctx, c, l);
+}
+
+/**
+ * Divides the clip-space lanes by w, and maps them to the viewport like
+ * `project_to_screen()`. Lanes outside the view frustum are computed too,
+ * and dropped by the caller.
+ *
+ * @param ctx Rendering context.
+ * @param c Clip-space x, y, z and w of the lanes.
+ * @param l Out screen positions and depths of the lanes.
+ */
+static inline void	screen_lanes(t_context *ctx, __m256 *c, t_lanes *l)
+{
+	__m256	inv;
+	__m256	half;
+	__m256	one;
+
+	one = _mm256_set1_ps(1.0f);
+	half = _mm256_set1_ps(0.5f);
+	inv = _mm256_div_ps(one, c[3]);
+	_mm256_storeu_si256((__m256i *)l->s[0], _mm256_cvttps_epi32(
+			_mm256_mul_ps(_mm256_mul_ps(_mm256_add_ps(_mm256_mul_ps(c[0],
+							inv), one), half),
+				_mm256_set1_ps(ctx->img->width - 1))));
+	_mm256_storeu_si256((__m256i *)l->s[1], _mm256_cvttps_epi32(
+			_mm256_mul_ps(_mm256_mul_ps(_mm256_sub_ps(one, _mm256_mul_ps(
+							c[1], inv)), half),
+				_mm256_set1_ps(ctx->img->height - 1))));
+	_mm256_storeu_ps(l->depth, _mm256_mul_ps(_mm256_add_ps(
+				_mm256_mul_ps(c[2], inv), one), half));
+}
+
+#elif defined(__SSE2__)
+
+static inline void	screen_lanes(t_context *ctx, __m128 *c, t_lanes *l);
+
+/**
+ * Transforms BATCH_LANES vertices of a batch into clip space with SSE2,
+ * 4 at a time, like `transform_vert()` does one at a time and with the
+ * same operations in the same order, so the results are identical.
+ * Bit `k` of each mask of `l->planes` is set if lane `k` lies outside the
+ * plane of the view frustum of the same index (see `outcode()`).
+ *
+ * Components of the vectors are indexed, as a t_vec4 is 4 packed floats.
+ *
+ * @param ctx Rendering context with the grid deltas of the frame.
+ * @param b Batch of vertices.
+ * @param i Index of the vertex of lane 0.
+ * @param l Out transformed lanes.
+ */
+void	transform_lanes(t_context *ctx, const t_batch *b, int i, t_lanes *l)
+{
+	__m128	xz[2];
+	__m128	c[4];
+	int		k;
+
+	xz[0] = _mm_loadu_ps(b->x + i);
+	xz[1] = _mm_loadu_ps(b->z + i);
+	k = -1;
+	while (++k < 4)
+	{
+		c[k] = _mm_add_ps(_mm_add_ps(_mm_set1_ps((&b->base.x)[k]),
+					_mm_mul_ps(xz[0], _mm_set1_ps((&ctx->m.dx.x)[k]))),
+				_mm_mul_ps(xz[1], _mm_set1_ps((&ctx->m.dz.x)[k])));
+		_mm_storeu_ps(l->clip[k], c[k]);
+	}
+	k = -1;
+	while (++k < 3)
+	{
+		l->planes[2 * k] = _mm_movemask_ps(_mm_cmplt_ps(
+					_mm_add_ps(c[k], c[3]), _mm_setzero_ps()));
+		l->planes[2 * k + 1] = _mm_movemask_ps(_mm_cmplt_ps(
+					_mm_sub_ps(c[3], c[k]), _mm_setzero_ps()));
+	}
+	screen_lanes(ctx, c, l);
+}
+
+/**
+ * Divides the clip-space lanes by w, and maps them to the viewport like
+ * `project_to_screen()`. Lanes outside the view frustum are computed too,
+ * and dropped by the caller.
+ *
+ * @param ctx Rendering context.
+ * @param c Clip-space x, y, z and w of the lanes.
+ * @param l Out screen positions and depths of the lanes.
+ */
+static inline void	screen_lanes(t_context *ctx, __m128 *c, t_lanes *l)
+{
+	__m128	inv;
+	__m128	half;
+	__m128	one;
+
+	one = _mm_set1_ps(1.0f);
+	half = _mm_set1_ps(0.5f);
+	inv = _mm_div_ps(one, c[3]);
+	_mm_storeu_si128((__m128i *)l->s[0], _mm_cvttps_epi32(
+			_mm_mul_ps(_mm_mul_ps(_mm_add_ps(_mm_mul_ps(c[0], inv), one),
+					half), _mm_set1_ps(ctx->img->width - 1))));
+	_mm_storeu_si128((__m128i *)l->s[1], _mm_cvttps_epi32(
+			_mm_mul_ps(_mm_mul_ps(_mm_sub_ps(one, _mm_mul_ps(c[1], inv)),
+					half), _mm_set1_ps(ctx->img->height - 1))));
+	_mm_storeu_ps(l->depth, _mm_mul_ps(_mm_add_ps(
+				_mm_mul_ps(c[2], inv), one), half));
+}
+
+#else
+
+/**
+ * Transforms a single lane with `transform_vert()`, for targets without
+ * SSE2, where BATCH_LANES is 1.
+ *
+ * @param ctx Rendering context with the grid deltas of the frame.
+ * @param b Batch of vertices.
+ * @param i Index of the vertex of the lane.
+ * @param l Out transformed lane.
+ */
+void	transform_lanes(t_context *ctx, const t_batch *b, int i, t_lanes *l)
+{
+	t_vertex	v;
+	t_post		p;
+	int			k;
+
+	v.pos = vec4(b->x[i], b->y, b->z[i], 1.0f);
+	v.color = b->color[i];
+	v.s = vec2i(0, 0);
+	v.depth = 0.0f;
+	transform_vert(ctx, b->base, v, &p);
+	l->clip[0][0] = p.v.pos.x;
+	l->clip[1][0] = p.v.pos.y;
+	l->clip[2][0] = p.v.pos.z;
+	l->clip[3][0] = p.v.pos.w;
+	l->s[0][0] = p.v.s.x;
+	l->s[1][0] = p.v.s.y;
+	l->depth[0] = p.v.depth;
+	k = -1;
+	while (++k < 6)
+		l->planes[k] = (p.out >> k) & 1;
+}
+
+#endif
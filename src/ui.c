@@ -6,7 +6,7 @@
 /*   By: myli-pen <myli-pen@student.hive.fi>        +#+  +:+       +#+        */
 /*                                                +#+#+#+#+#+   +#+           */
 /*   Created: 2025/07/25 01:10:00 by myli-pen          #+#    #+#             */
-/*   Updated: 2025/08/09 01:58:19 by myli-pen         ###   ########.fr       */
+/*   Updated: 2026/10/18 00:39:43 by myli-pen         ###   ########.fr       */
 /*                                                                            */
 /* ************************************************************************** */
 
@@ -34,17 +34,16 @@ static inline void	update_ui_1(t_context *ctx)
 {
 	static mlx_image_t	*proj;
 
-	if (proj)
-		mlx_delete_image(ctx->mlx, proj);
+	memory_delete_image(ctx, &proj, MEM_UI);
 	if (ctx->cam.projection == ISOMETRIC)
 		proj = mlx_put_string(ctx->mlx, "Isometric", 100, 60);
 	else if (ctx->cam.projection == ORTHOGRAPHIC)
 		proj = mlx_put_string(ctx->mlx, "Orthographic", 100, 60);
 	else if (ctx->cam.projection == PERSPECTIVE)
 		proj = mlx_put_string(ctx->mlx, "Perspective", 100, 60);
-	if (!proj)
+	if (!memory_image(ctx, proj, MEM_UI))
 	{
-		fdf_free(ctx->verts, ctx->tris, ctx);
+		fdf_free(ctx);
 		ft_error(ctx->mlx, "ui 1", ctx);
 	}
 }
@@ -60,8 +59,7 @@ static inline void	update_ui_2(t_context *ctx)
 	char				*str;
 	int					y;
 
-	if (controls)
-		mlx_delete_image(ctx->mlx, controls);
+	memory_delete_image(ctx, &controls, MEM_UI);
 	if (ctx->cam.projection == PERSPECTIVE)
 		str = "[WASD]move  [ARROWS]rotate  [SPACE]spin  [F]frame  [U-I]fov";
 	else
@@ -70,9 +68,9 @@ static inline void	update_ui_2(t_context *ctx)
 	{
 		y = ft_imax(100, ctx->img->height - 110);
 		controls = mlx_put_string(ctx->mlx, str, 100, y);
-		if (!controls)
+		if (!memory_image(ctx, controls, MEM_UI))
 		{
-		fdf_free(ctx->verts, ctx->tris, ctx);
+		fdf_free(ctx);
 		ft_error(ctx->mlx, "ui 2", ctx);
 		}
 		controls->instances[0].z = 101;
@@ -89,16 +87,15 @@ static inline void	update_ui_3(t_context *ctx)
 	static mlx_image_t	*info;
 	char				*str_i;
 
-	if (info)
-		mlx_delete_image(ctx->mlx, info);
+	memory_delete_image(ctx, &info, MEM_UI);
 	str_i = "[ESC]quit  [P]projection [C]color  [R]reset";
 	if (ctx->cam.projection == ISOMETRIC)
 		str_i = "[ESC]quit  [P]projection";
 	info = mlx_put_string(ctx->mlx, str_i, 100,
 			ft_imax(100, ctx->img->height - 75));
-	if (!info)
+	if (!memory_image(ctx, info, MEM_UI))
 	{
-		fdf_free(ctx->verts, ctx->tris, ctx);
+		fdf_free(ctx);
 		ft_error(ctx->mlx, "ui 3-1", ctx);
 	}
 	info->instances[0].z = 102;
@@ -114,16 +111,15 @@ static inline void	update_ui_4(t_context *ctx)
 	static mlx_image_t	*controls;
 	char				*str_c;
 
-	if (controls)
-		mlx_delete_image(ctx->mlx, controls);
+	memory_delete_image(ctx, &controls, MEM_UI);
 	if (ctx->cam.projection == ISOMETRIC)
 		return ;
 	str_c = "[MMB]pan  [RMB]zoom  [LMB]orbit";
 	controls = mlx_put_string(ctx->mlx, str_c, 100,
 			ft_imax(100, ctx->img->height - 145));
-	if (!controls)
+	if (!memory_image(ctx, controls, MEM_UI))
 	{
-		fdf_free(ctx->verts, ctx->tris, ctx);
+		fdf_free(ctx);
 		ft_error(ctx->mlx, "ui 4", ctx);
 	}
 	controls->instances[0].z = 103;
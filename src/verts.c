@@ -0,0 +1,125 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   verts.c                                            :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: myli-pen <myli-pen@student.hive.fi>        +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/17 23:44:33 by myli-pen          #+#    #+#             */
+/*   Updated: 2026/10/18 00:30:47 by myli-pen         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "fdf.h"
+
+static inline bool	copy_array(t_verts *dst, t_verts *src, int k, size_t n);
+
+/**
+ * Allocates the compact vertex store of a grid. The x and y of a vertex
+ * follow from its index, so only its height and color are stored:
+ *
+ * - The heights as int16, aligned to VERT_ALIGN. Heights outside the int16
+ * range are escaped with Z_ESC and kept in the VERT_WIDE int32 array.
+ *
+ * - The colors as one byte indices into `palette`, whose entry 0 is WHITE,
+ * in the VERT_INDEX array. Colors past the palette are escaped with
+ * COLOR_ESC and kept in the VERT_COLOR array.
+ *
+ * Every array is bump allocated from one arena reserved for the worst case,
+ * so the store is contiguous and freed with a single unmap. The optional
+ * arrays are only allocated by `vert_put()` once a vertex needs them, and
+ * untouched arena pages take no memory, so a map of WHITE int16 heights
+ * takes 2 bytes per vertex.
+ *
+ * @param verts Out vertex store, `z` is NULL on failure.
+ * @param rows Number of rows.
+ * @param cols Number of columns.
+ * @return `true` on success, `false` on allocation failure.
+ */
+bool	verts_alloc(t_verts *verts, int rows, int cols)
+{
+	int	k;
+
+	verts->count = (size_t)rows * cols;
+	verts->cols = cols;
+	verts->elem[VERT_WIDE] = sizeof(int32_t);
+	verts->elem[VERT_INDEX] = sizeof(uint8_t);
+	verts->elem[VERT_COLOR] = sizeof(uint32_t);
+	verts->z = NULL;
+	if (ft_arena_init(&verts->arena, verts->count * (sizeof(int16_t) +
+				sizeof(int32_t) + sizeof(uint8_t) + sizeof(uint32_t)) +
+			(VERT_ARRAYS + 1) * VERT_ALIGN))
+		verts->z = ft_arena_alloc(&verts->arena,
+				verts->count * sizeof(int16_t), VERT_ALIGN);
+	k = -1;
+	while (++k < VERT_ARRAYS)
+		atomic_init(&verts->arrays[k], 0);
+	atomic_init(&verts->colors, 1);
+	verts->palette[0] = WHITE;
+	ft_memset(verts->hint, 0, sizeof(verts->hint));
+	return (verts->z != NULL);
+}
+
+/**
+ * Copies the first `n` vertices of a vertex store into another, freshly
+ * allocated one, along with the palette and the arrays the source needed.
+ *
+ * @param dst Vertex store of at least `n` vertices.
+ * @param src Vertex store to copy from.
+ * @param n Number of vertices.
+ * @return `true` on success, `false` on allocation failure.
+ */
+bool	verts_copy(t_verts *dst, t_verts *src, size_t n)
+{
+	int	k;
+
+	ft_memcpy(dst->z, src->z, n * sizeof(int16_t));
+	ft_memcpy(dst->palette, src->palette, sizeof(src->palette));
+	atomic_store(&dst->colors, atomic_load(&src->colors));
+	k = -1;
+	while (++k < VERT_ARRAYS)
+		if (!copy_array(dst, src, k, n))
+			return (false);
+	return (true);
+}
+
+/**
+ * Frees a vertex store, unmapping its arena and every array in it at once.
+ *
+ * @param verts Vertex store.
+ */
+void	verts_free(t_verts *verts)
+{
+	int	k;
+
+	ft_arena_free(&verts->arena);
+	verts->z = NULL;
+	k = -1;
+	while (++k < VERT_ARRAYS)
+		atomic_store(&verts->arrays[k], 0);
+}
+
+/**
+ * Allocates an optional array of the destination store if the source has
+ * it, and copies its first `n` elements into it.
+ *
+ * @param dst Destination vertex store.
+ * @param src Source vertex store.
+ * @param k Array to copy, VERT_WIDE, VERT_INDEX or VERT_COLOR.
+ * @param n Number of vertices.
+ * @return `true` on success, `false` on allocation failure.
+ */
+static inline bool	copy_array(t_verts *dst, t_verts *src, int k, size_t n)
+{
+	void	*array;
+
+	if (!atomic_load(&src->arrays[k]))
+		return (true);
+	array = ft_arena_alloc(&dst->arena, dst->count * dst->elem[k],
+			VERT_ALIGN);
+	if (!array)
+		return (false);
+	ft_memcpy(array, (void *)atomic_load(&src->arrays[k]), n * dst->elem[k]);
+	atomic_store(&dst->arrays[k], (uintptr_t)array);
+	return (true);
+}
@@ -0,0 +1,48 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   verts_get.c                                        :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: myli-pen <myli-pen@student.hive.fi>        +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/17 23:55:50 by myli-pen          #+#    #+#             */
+/*   Updated: 2026/10/18 02:46:35 by myli-pen         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "fdf.h"
+
+/**
+ * Decodes the height of a vertex, looking up the int32 array for escaped
+ * heights.
+ *
+ * @param verts Vertex store.
+ * @param i Vertex index.
+ * @return Height of the vertex.
+ */
+int	vert_z(t_verts *verts, size_t i)
+{
+	if (verts->z[i] != Z_ESC)
+		return (verts->z[i]);
+	return (((int32_t *)atomic_load(&verts->arrays[VERT_WIDE]))[i]);
+}
+
+/**
+ * Decodes the color of a vertex from its palette index. Vertices are WHITE
+ * while no index array exists, and escaped indices look up the color array.
+ *
+ * @param verts Vertex store.
+ * @param i Vertex index.
+ * @return Color of the vertex (32-bit RGBA).
+ */
+uint32_t	vert_color(t_verts *verts, size_t i)
+{
+	uint8_t	*index;
+
+	index = (uint8_t *)atomic_load(&verts->arrays[VERT_INDEX]);
+	if (!index)
+		return (WHITE);
+	if (index[i] != COLOR_ESC)
+		return (verts->palette[index[i]]);
+	return (((uint32_t *)atomic_load(&verts->arrays[VERT_COLOR]))[i]);
+}
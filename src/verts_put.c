@@ -0,0 +1,168 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   verts_put.c                                        :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: myli-pen <myli-pen@student.hive.fi>        +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/17 23:55:50 by myli-pen          #+#    #+#             */
+/*   Updated: 2026/10/18 00:39:43 by myli-pen         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "fdf.h"
+
+static inline bool	put_color(t_context *ctx, size_t i, uint32_t color);
+static inline int	palette_index(t_context *ctx, uint32_t color);
+static inline int	palette_add(t_context *ctx, uint32_t color, int k);
+static inline void	*lazy_array(t_context *ctx, int k);
+
+/**
+ * Encodes a vertex into the compact store (see `verts_alloc()`).
+ *
+ * Called concurrently by the parser threads for different vertices, so the
+ * optional arrays and the palette are only changed under the loader lock.
+ *
+ * @param ctx Rendering context containing the vertex store.
+ * @param i Vertex index.
+ * @param z Height of the vertex.
+ * @param color Color of the vertex (32-bit RGBA).
+ * @return `true` on success, `false` on allocation failure.
+ */
+bool	vert_put(t_context *ctx, size_t i, int z, uint32_t color)
+{
+	int32_t	*wide;
+
+	if (z > Z_ESC && z <= INT16_MAX)
+		ctx->verts.z[i] = z;
+	else
+	{
+		wide = lazy_array(ctx, VERT_WIDE);
+		if (!wide)
+			return (false);
+		wide[i] = z;
+		ctx->verts.z[i] = Z_ESC;
+	}
+	return (put_color(ctx, i, color));
+}
+
+/**
+ * Stores the palette index of a vertex color. WHITE is index 0, which the
+ * zeroed index array already holds.
+ *
+ * @param ctx Rendering context containing the vertex store.
+ * @param i Vertex index.
+ * @param color Color of the vertex.
+ * @return `true` on success, `false` on allocation failure.
+ */
+static inline bool	put_color(t_context *ctx, size_t i, uint32_t color)
+{
+	uint8_t		*index;
+	uint32_t	*colors;
+	int			k;
+
+	if (color == WHITE)
+		return (true);
+	index = lazy_array(ctx, VERT_INDEX);
+	if (!index)
+		return (false);
+	k = palette_index(ctx, color);
+	if (k == COLOR_ESC)
+	{
+		colors = lazy_array(ctx, VERT_COLOR);
+		if (!colors)
+			return (false);
+		colors[i] = color;
+	}
+	index[i] = k;
+	return (true);
+}
+
+/**
+ * Finds the palette index of a color, adding the color if it is new.
+ * Entries below `colors` never change, so they are searched without the
+ * lock. The last index found for each hash of a color is tried first, and a
+ * full palette is not searched, as escaped colors need no index.
+ *
+ * @param ctx Rendering context containing the vertex store.
+ * @param color Color to find.
+ * @return Palette index, or COLOR_ESC once the palette is full.
+ */
+static inline int	palette_index(t_context *ctx, uint32_t color)
+{
+	uint8_t	hash;
+	int		n;
+	int		k;
+
+	hash = color * 2654435761u >> 24;
+	k = atomic_load(&ctx->verts.hint[hash]);
+	if (ctx->verts.palette[k] == color)
+		return (k);
+	n = atomic_load(&ctx->verts.colors);
+	if (n == COLOR_ESC)
+		return (COLOR_ESC);
+	k = 1;
+	while (k < n && ctx->verts.palette[k] != color)
+		k++;
+	if (k == n)
+		k = palette_add(ctx, color, n);
+	if (k != COLOR_ESC)
+		atomic_store(&ctx->verts.hint[hash], k);
+	return (k);
+}
+
+/**
+ * Adds a color to the palette under the lock, unless another thread added
+ * it since the palette was searched up to `k`.
+ *
+ * @param ctx Rendering context containing the vertex store.
+ * @param color Color to add.
+ * @param k Number of palette entries already searched.
+ * @return Palette index, or COLOR_ESC if the palette is full.
+ */
+static inline int	palette_add(t_context *ctx, uint32_t color, int k)
+{
+	int	n;
+
+	pthread_mutex_lock(&ctx->load.lock);
+	n = atomic_load(&ctx->verts.colors);
+	while (k < n && ctx->verts.palette[k] != color)
+		k++;
+	if (k == n && n < COLOR_ESC)
+	{
+		ctx->verts.palette[n] = color;
+		atomic_store(&ctx->verts.colors, n + 1);
+	}
+	pthread_mutex_unlock(&ctx->load.lock);
+	return (k);
+}
+
+/**
+ * Returns an optional array of the vertex store, allocating it for every
+ * vertex from the store arena the first time a vertex needs it. The arena
+ * is fresh, so the array is zeroed.
+ *
+ * @param ctx Rendering context containing the vertex store.
+ * @param k Array to get, VERT_WIDE, VERT_INDEX or VERT_COLOR.
+ * @return The array, or NULL on allocation failure.
+ */
+static inline void	*lazy_array(t_context *ctx, int k)
+{
+	void	*data;
+
+	data = (void *)atomic_load(&ctx->verts.arrays[k]);
+	if (data)
+		return (data);
+	pthread_mutex_lock(&ctx->load.lock);
+	data = (void *)atomic_load(&ctx->verts.arrays[k]);
+	if (!data)
+	{
+		data = ft_arena_alloc(&ctx->verts.arena,
+				ctx->verts.count * ctx->verts.elem[k], VERT_ALIGN);
+		atomic_store(&ctx->verts.arrays[k], (uintptr_t)data);
+		if (data)
+			memory_track(ctx, MEM_VERTS, ctx->verts.count * ctx->verts.elem[k]);
+	}
+	pthread_mutex_unlock(&ctx->load.lock);
+	return (data);
+}
@@ -0,0 +1,43 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   view.c                                             :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: myli-pen <myli-pen@student.hive.fi>        +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/18 00:12:38 by myli-pen          #+#    #+#             */
+/*   Updated: 2026/10/18 00:14:31 by myli-pen         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "fdf.h"
+
+/**
+ * Checks if anything the image depends on changed since the last rendered
+ * frame: the camera, the transform, the color and spin modes, the colors of
+ * the color mode and the window size. Stores the current state for the next
+ * frame.
+ *
+ * The state is compared byte by byte, so a change can only be missed if
+ * nothing changed, at worst an equal state is rendered again.
+ *
+ * @param ctx Rendering context.
+ * @return `true` if the frame must be rendered again.
+ */
+bool	view_changed(t_context *ctx)
+{
+	t_view	view;
+
+	ft_bzero(&view, sizeof(t_view));
+	view.cam = ctx->cam;
+	view.transform = ctx->transform;
+	view.color_mode = ctx->color_mode;
+	view.spin_mode = ctx->spin_mode;
+	view.color1 = ctx->color1;
+	view.color2 = ctx->color2;
+	view.size = vec2i(ctx->img->width, ctx->img->height);
+	if (!ft_memcmp(&view, &ctx->view, sizeof(t_view)))
+		return (false);
+	ctx->view = view;
+	return (true);
+}
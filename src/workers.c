@@ -0,0 +1,144 @@
+/* ************************************************************************** */
+/*                                                                            */
+/*                                                        :::      ::::::::   */
+/*   workers.c                                          :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: myli-pen <myli-pen@student.hive.fi>        +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/18 00:43:39 by myli-pen          #+#    #+#             */
+/*   Updated: 2026/10/18 04:04:16 by myli-pen         ###   ########.fr       */
+/*                                                                            */
+/* ************************************************************************** */
+
+#include "fdf.h"
+
+/**
+ * Sets up the workers that draw the frames: RASTER_THREADS of them, or one
+ * per online processor by default, capped at THREADS_MAX. Their threads
+ * are started once, here (see `start_pool()`).
+ *
+ * @param ctx Rendering context.
+ */
+void	init_workers(t_context *ctx)
+{
+	long	n;
+	int		k;
+
+	n = RASTER_THREADS;
+	if (n < 1)
+		n = sysconf(_SC_NPROCESSORS_ONLN);
+	if (n > THREADS_MAX)
+		n = THREADS_MAX;
+	ctx->workers.threads = ft_imax(1, n);
+	ctx->workers.producers = 0;
+	ctx->workers.bands = 1;
+	ctx->workers.band_rows = BAND_ROWS;
+	atomic_init(&ctx->workers.next, 0);
+	atomic_init(&ctx->workers.dropped, false);
+	k = -1;
+	while (++k < THREADS_MAX)
+	{
+		ft_bzero(&ctx->workers.worker[k], sizeof(t_worker));
+		ctx->workers.worker[k].ctx = ctx;
+	}
+	start_pool(ctx);
+}
+
+/**
+ * Prepares the scratch of a worker for a batch of at most `cap` segments:
+ * two rows of the post-transform buffer, the segments, and the offsets of
+ * their bands (see `bin_segments()`). Every allocation is bumped from the
+ * arena of the worker, which is reset for each batch and only reserved
+ * again when it is too small. Only used on the main loop.
+ *
+ * @param w Worker.
+ * @param cap Largest number of segments of the batch.
+ * @return `true` on success, `false` on allocation failure.
+ */
+bool	worker_scratch(t_worker *w, size_t cap)
+{
+	t_context	*ctx;
+	size_t		size;
+
+	ctx = w->ctx;
+	size = 2 * (size_t)ctx->rows_cols.y * sizeof(t_post) + cap *
+		sizeof(t_segment) + (ctx->workers.bands + 1) * sizeof(uint32_t) +
+		3 * VERT_ALIGN;
+	ft_arena_reset(&w->arena);
+	if (size > w->arena.size)
+	{
+		memory_track(ctx, MEM_FRAME, -(ssize_t)w->arena.size);
+		ft_arena_free(&w->arena);
+		if (ft_arena_init(&w->arena, size))
+			memory_track(ctx, MEM_FRAME, size);
+	}
+	w->post = ft_arena_alloc(&w->arena,
+			2 * (size_t)ctx->rows_cols.y * sizeof(t_post), VERT_ALIGN);
+	w->segs = ft_arena_alloc(&w->arena, cap * sizeof(t_segment), VERT_ALIGN);
+	w->count = 0;
+	w->cap = cap;
+	return (w->post && w->segs);
+}
+
+/**
+ * Reserves the bins of the batch of a worker, once its segments have been
+ * counted in every band they cross (see `bin_segments()`). The bins have an
+ * arena of their own, reset for each batch and only reserved again when it
+ * is too small, so it follows the bins actually filled, rather than every
+ * segment of the batch crossing every band.
+ *
+ * @param w Worker.
+ * @param total Number of segments over every band.
+ * @return `true` on success, `false` on allocation failure.
+ */
+bool	worker_bins(t_worker *w, size_t total)
+{
+	size_t	size;
+
+	size = total * sizeof(uint32_t) + VERT_ALIGN;
+	ft_arena_reset(&w->bin_arena);
+	if (size > w->bin_arena.size)
+	{
+		memory_track(w->ctx, MEM_FRAME, -(ssize_t)w->bin_arena.size);
+		ft_arena_free(&w->bin_arena);
+		if (ft_arena_init(&w->bin_arena, size))
+			memory_track(w->ctx, MEM_FRAME, size);
+	}
+	w->bins = ft_arena_alloc(&w->bin_arena, total * sizeof(uint32_t),
+			VERT_ALIGN);
+	return (w->bins != NULL);
+}
+
+/**
+ * Draws the segments emitted so far by a single worker, and starts its next
+ * batch.
+ *
+ * @param w Worker.
+ * @return `true` if every segment was drawn and the next batch started.
+ */
+bool	flush_worker(t_worker *w)
+{
+	bool	ok;
+
+	bin_segments(w);
+	ok = raster_segments(w->ctx, 1);
+	return (worker_scratch(w, w->cap) && ok);
+}
+
+/**
+ * Joins the threads of the workers and releases their scratch.
+ *
+ * @param ctx Rendering context.
+ */
+void	free_workers(t_context *ctx)
+{
+	int	k;
+
+	stop_pool(ctx);
+	k = -1;
+	while (++k < THREADS_MAX)
+	{
+		ft_arena_free(&ctx->workers.worker[k].arena);
+		ft_arena_free(&ctx->workers.worker[k].bin_arena);
+	}
+}